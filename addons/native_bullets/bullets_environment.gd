@@ -9,6 +9,16 @@ export(bool) var current = true setget _set_current
 export(Array, Resource) var bullet_kits: Array
 export(Array, int) var pools_sizes: Array
 export(Array, int) var z_indices: Array
+# Sizes pools can grow up to when they run out of bullets, values lower than the pool size keep it fixed.
+export(Array, int) var max_pools_sizes: Array
+# Seconds the bullets added by a pool growing have to be unused before they are removed, 0 never removes them.
+export(float) var pools_shrink_delay = 0.0
+# Whether bullets of kits also used by the previous environment stay active when this one is mounted.
+export(bool) var keep_bullets = false
+# Milliseconds per frame spent creating the bullets of the pools, 0 creates them all when the environment is mounted.
+export(float) var warm_up_budget = 0.0
+# Whether batched kits are drawn from a single atlas, so that the ones sharing a material and z index need one draw.
+export(bool) var use_atlas = false
 
 var properties_regex : RegEx
 
@@ -66,6 +76,8 @@ func _get(property: String):
 				return pools_sizes[prop_index]
 			elif strings[1] == "z_index":
 				return z_indices[prop_index]
+			elif strings[1] == "max_pool_size":
+				return max_pools_sizes[prop_index] if max_pools_sizes.size() > prop_index else 0
 	return null
 
 
@@ -74,6 +86,7 @@ func _set(property: String, value):
 		bullet_kits.resize(value)
 		pools_sizes.resize(value)
 		z_indices.resize(value)
+		max_pools_sizes.resize(value)
 		property_list_changed_notify()
 		return true
 	
@@ -91,6 +104,10 @@ func _set(property: String, value):
 			elif strings[1] == "z_index":
 				z_indices[prop_index] = value
 				return true
+			elif strings[1] == "max_pool_size":
+				max_pools_sizes.resize(bullet_kits.size())
+				max_pools_sizes[prop_index] = value
+				return true
 	return false
 
 
@@ -122,6 +139,13 @@ func _get_property_list():
 			"hint": PROPERTY_HINT_RANGE,
 			"hint_string": "1,65536"
 		})
+		properties.append({
+			"name": "bullet_type_{0}/max_pool_size".format(format_array),
+			"type": TYPE_INT,
+			"usage": PROPERTY_USAGE_DEFAULT,
+			"hint": PROPERTY_HINT_RANGE,
+			"hint_string": "0,1048576"
+		})
 		properties.append({
 			"name": "bullet_type_{0}/z_index".format(format_array),
 			"type": TYPE_INT,
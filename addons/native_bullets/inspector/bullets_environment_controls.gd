@@ -44,13 +44,17 @@ func _on_move_up_pressed():
 	var bullet_kit = object.bullet_kits[index]
 	var pool_size = object.pools_sizes[index]
 	var z_index = object.z_indices[index]
+	object.max_pools_sizes.resize(object.bullet_kits.size())
+	var max_pool_size = object.max_pools_sizes[index]
 	
 	object.bullet_kits.remove(index)
 	object.pools_sizes.remove(index)
 	object.z_indices.remove(index)
+	object.max_pools_sizes.remove(index)
 	object.bullet_kits.insert(index -1, bullet_kit)
 	object.pools_sizes.insert(index - 1, pool_size)
 	object.z_indices.insert(index - 1, z_index)
+	object.max_pools_sizes.insert(index - 1, max_pool_size)
 	
 	object.property_list_changed_notify()
 
@@ -59,20 +63,26 @@ func _on_move_down_pressed():
 	var bullet_kit = object.bullet_kits[index]
 	var pool_size = object.pools_sizes[index]
 	var z_index = object.z_indices[index]
+	object.max_pools_sizes.resize(object.bullet_kits.size())
+	var max_pool_size = object.max_pools_sizes[index]
 	
 	object.bullet_kits.remove(index)
 	object.pools_sizes.remove(index)
 	object.z_indices.remove(index)
+	object.max_pools_sizes.remove(index)
 	object.bullet_kits.insert(index + 1, bullet_kit)
 	object.pools_sizes.insert(index + 1, pool_size)
 	object.z_indices.insert(index + 1, z_index)
+	object.max_pools_sizes.insert(index + 1, max_pool_size)
 	
 	object.property_list_changed_notify()
 
 
 func _on_delete_pressed():
+	object.max_pools_sizes.resize(object.bullet_kits.size())
 	object.bullet_kits.remove(index)
 	object.pools_sizes.remove(index)
 	object.z_indices.remove(index)
+	object.max_pools_sizes.remove(index)
 	
 	object.property_list_changed_notify()
@@ -0,0 +1,99 @@
+#ifndef BATCH_GROUP_H
+#define BATCH_GROUP_H
+
+#include <Godot.hpp>
+#include <VisualServer.hpp>
+#include <Array.hpp>
+
+#include <vector>
+
+using namespace godot;
+
+
+class BulletsPool;
+
+// A single MultiMesh drawing the bullets of every batched pool sharing a material and a z index,
+// with their textures packed in the same atlas.
+// Each instance has a 2D transform, a color and, as custom data, the rect of its texture in the atlas.
+struct BatchGroup {
+	static const int32_t instance_floats = 16;
+
+	RID material;
+	int32_t z_index = 0;
+	RID atlas;
+	std::vector<BulletsPool*> pools;
+
+	RID canvas_item;
+	RID mesh;
+	RID multimesh;
+	// Instances the MultiMesh has been allocated for, it only grows.
+	int32_t capacity = 0;
+	PoolRealArray instances_data;
+	// Set by the pools when their instances changed since the last upload.
+	bool dirty = true;
+
+	void create(RID canvas_parent, RID material, int32_t z_index, RID atlas) {
+		this->material = material;
+		this->z_index = z_index;
+		this->atlas = atlas;
+
+		canvas_item = VisualServer::get_singleton()->canvas_item_create();
+		VisualServer::get_singleton()->canvas_item_set_parent(canvas_item, canvas_parent);
+		VisualServer::get_singleton()->canvas_item_set_z_index(canvas_item, z_index);
+		VisualServer::get_singleton()->canvas_item_set_material(canvas_item, material);
+
+		// A unit quad, the instance transforms scale it to the size of each texture.
+		PoolVector2Array vertices = PoolVector2Array();
+		vertices.append(Vector2(-0.5f, -0.5f));
+		vertices.append(Vector2(0.5f, -0.5f));
+		vertices.append(Vector2(0.5f, 0.5f));
+		vertices.append(Vector2(-0.5f, 0.5f));
+		PoolVector2Array uvs = PoolVector2Array();
+		uvs.append(Vector2(0.0f, 0.0f));
+		uvs.append(Vector2(1.0f, 0.0f));
+		uvs.append(Vector2(1.0f, 1.0f));
+		uvs.append(Vector2(0.0f, 1.0f));
+		PoolIntArray indices = PoolIntArray();
+		indices.append(0);
+		indices.append(1);
+		indices.append(2);
+		indices.append(0);
+		indices.append(2);
+		indices.append(3);
+
+		Array arrays = Array();
+		arrays.resize(VisualServer::ARRAY_MAX);
+		arrays[VisualServer::ARRAY_VERTEX] = vertices;
+		arrays[VisualServer::ARRAY_TEX_UV] = uvs;
+		arrays[VisualServer::ARRAY_INDEX] = indices;
+
+		mesh = VisualServer::get_singleton()->mesh_create();
+		VisualServer::get_singleton()->mesh_add_surface_from_arrays(mesh, VisualServer::PRIMITIVE_TRIANGLES, arrays);
+
+		multimesh = VisualServer::get_singleton()->multimesh_create();
+		VisualServer::get_singleton()->multimesh_set_mesh(multimesh, mesh);
+
+		VisualServer::get_singleton()->canvas_item_add_multimesh(canvas_item, multimesh, atlas);
+	}
+
+	// Makes room for `amount` instances, the content of the MultiMesh is lost if it has to grow.
+	void reserve(int32_t amount) {
+		if(amount <= capacity) {
+			return;
+		}
+		capacity = amount > capacity * 2 ? amount : capacity * 2;
+		VisualServer::get_singleton()->multimesh_allocate(multimesh, capacity, VisualServer::MULTIMESH_TRANSFORM_2D,
+			VisualServer::MULTIMESH_COLOR_FLOAT, VisualServer::MULTIMESH_CUSTOM_DATA_FLOAT);
+		instances_data.resize(capacity * instance_floats);
+	}
+
+	~BatchGroup() {
+		if(multimesh.is_valid()) {
+			VisualServer::get_singleton()->free_rid(multimesh);
+			VisualServer::get_singleton()->free_rid(mesh);
+			VisualServer::get_singleton()->free_rid(canvas_item);
+		}
+	}
+};
+
+#endif
\ No newline at end of file
@@ -4,6 +4,9 @@
 #include <Godot.hpp>
 #include <Transform2D.hpp>
 
+#include <vector>
+#include <utility>
+
 using namespace godot;
 
 
@@ -12,42 +15,421 @@ struct BulletID {
 	int32_t cycle;
 	int32_t set;
 
-	BulletID(int32_t index, int32_t cycle, int32_t set): 
+	BulletID(int32_t index, int32_t cycle, int32_t set):
 		index(index), cycle(cycle), set(set) {}
 };
 
+// A per-bullet field declared by the kit through its custom_fields, stored natively instead of in a Variant.
+// Floats, vectors and colors use 1, 2 or 4 consecutive reals per bullet, ints and bools an integer.
+struct CustomColumn {
+	String name;
+	Variant::Type type = Variant::NIL;
+	int32_t width = 1;
+	std::vector<float> reals;
+	std::vector<int32_t> integers;
+	// Value bullets get when they are spawned, in the same layout.
+	float default_reals[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+	int32_t default_integer = 0;
+
+	// Returns false if the type of `value` can't be stored natively.
+	bool declare(const String& name, const Variant& value) {
+		this->name = name;
+		this->type = value.get_type();
+		switch(type) {
+			case Variant::BOOL:
+			case Variant::INT:
+				default_integer = value;
+				break;
+			case Variant::REAL:
+				width = 1;
+				default_reals[0] = value;
+				break;
+			case Variant::VECTOR2: {
+				width = 2;
+				Vector2 vector = value;
+				default_reals[0] = vector.x;
+				default_reals[1] = vector.y;
+			} break;
+			case Variant::COLOR: {
+				width = 4;
+				Color color = value;
+				default_reals[0] = color.r;
+				default_reals[1] = color.g;
+				default_reals[2] = color.b;
+				default_reals[3] = color.a;
+			} break;
+			default:
+				return false;
+		}
+		return true;
+	}
+
+	bool is_integer() const {
+		return type == Variant::INT || type == Variant::BOOL;
+	}
+
+	void resize(int32_t size) {
+		if(is_integer()) {
+			integers.resize(size, default_integer);
+			return;
+		}
+		int32_t previous_size = (int32_t)reals.size() / width;
+		reals.resize(size * width);
+		for(int32_t i = previous_size; i < size; i++) {
+			reset(i);
+		}
+	}
+
+	void erase_front(int32_t amount) {
+		if(is_integer()) {
+			integers.erase(integers.begin(), integers.begin() + amount);
+		} else {
+			reals.erase(reals.begin(), reals.begin() + amount * width);
+		}
+	}
+
+	void swap(int32_t a, int32_t b) {
+		if(is_integer()) {
+			std::swap(integers[a], integers[b]);
+			return;
+		}
+		for(int32_t i = 0; i < width; i++) {
+			std::swap(reals[a * width + i], reals[b * width + i]);
+		}
+	}
+
+	void reset(int32_t index) {
+		if(is_integer()) {
+			integers[index] = default_integer;
+			return;
+		}
+		for(int32_t i = 0; i < width; i++) {
+			reals[index * width + i] = default_reals[i];
+		}
+	}
+
+	float get_real(int32_t index) const { return reals[index]; }
+	void set_real(int32_t index, float value) { reals[index] = value; }
+
+	int32_t get_integer(int32_t index) const { return integers[index]; }
+	void set_integer(int32_t index, int32_t value) { integers[index] = value; }
+
+	Vector2 get_vector2(int32_t index) const {
+		return Vector2(reals[index * 2], reals[index * 2 + 1]);
+	}
+
+	void set_vector2(int32_t index, const Vector2& value) {
+		reals[index * 2] = value.x;
+		reals[index * 2 + 1] = value.y;
+	}
+
+	Color get_color(int32_t index) const {
+		return Color(reals[index * 4], reals[index * 4 + 1], reals[index * 4 + 2], reals[index * 4 + 3]);
+	}
+
+	void set_color(int32_t index, const Color& value) {
+		reals[index * 4] = value.r;
+		reals[index * 4 + 1] = value.g;
+		reals[index * 4 + 2] = value.b;
+		reals[index * 4 + 3] = value.a;
+	}
+
+	Variant get(int32_t index) const {
+		switch(type) {
+			case Variant::BOOL:
+				return integers[index] != 0;
+			case Variant::INT:
+				return integers[index];
+			case Variant::REAL:
+				return get_real(index);
+			case Variant::VECTOR2:
+				return get_vector2(index);
+			default:
+				return get_color(index);
+		}
+	}
+
+	void set(int32_t index, const Variant& value) {
+		switch(type) {
+			case Variant::BOOL:
+			case Variant::INT:
+				set_integer(index, value);
+				break;
+			case Variant::REAL:
+				set_real(index, value);
+				break;
+			case Variant::VECTOR2:
+				set_vector2(index, value);
+				break;
+			default:
+				set_color(index, value);
+				break;
+		}
+	}
+};
+
+// The state shared by every kind of bullet, stored as parallel arrays indexed by the bullet position in its pool.
+// The transform is split in its origin and basis axes, so that moving bullets only touches contiguous memory.
+struct BulletsStorage {
+	std::vector<Vector2> origins;
+	std::vector<Vector2> x_axes;
+	std::vector<Vector2> y_axes;
+	std::vector<Vector2> velocities;
+	std::vector<float> lifetimes;
+	std::vector<int32_t> cycles;
+	std::vector<int32_t> shape_indices;
+	std::vector<RID> item_rids;
+	// Allocated the first time a bullet data is set, most kits never use it.
+	std::vector<Variant> data;
+	// Fields declared by the kit.
+	std::vector<CustomColumn> custom_columns;
+	// Set when the transform changed since it was last sent to the servers.
+	// Code moving bullets without the setters below has to set it too.
+	std::vector<uint8_t> transforms_dirty;
+	// Velocity each bullet basis was last aligned to by face_velocity, valid when the flag is set.
+	std::vector<Vector2> faced_velocities;
+	std::vector<uint8_t> facing_valid;
+	// Seconds added to the lifetime of each bullet to find its animation frame.
+	std::vector<float> animation_phases;
+	// Animation frame of each bullet, and the one its canvas item draws when bullets have their own.
+	std::vector<int32_t> frames;
+	std::vector<int32_t> drawn_frames;
+
+	void resize(int32_t size) {
+		origins.resize(size);
+		x_axes.resize(size, Vector2(1.0f, 0.0f));
+		y_axes.resize(size, Vector2(0.0f, 1.0f));
+		velocities.resize(size);
+		lifetimes.resize(size, 0.0f);
+		cycles.resize(size, 0);
+		shape_indices.resize(size, -1);
+		item_rids.resize(size);
+		if(!data.empty()) {
+			data.resize(size);
+		}
+		for(int32_t i = 0; i < (int32_t)custom_columns.size(); i++) {
+			custom_columns[i].resize(size);
+		}
+		transforms_dirty.resize(size, 1);
+		faced_velocities.resize(size);
+		facing_valid.resize(size, 0);
+		animation_phases.resize(size, 0.0f);
+		frames.resize(size, 0);
+		drawn_frames.resize(size, -1);
+	}
+
+	// Removes the first `amount` bullets, shifting the others.
+	void erase_front(int32_t amount) {
+		origins.erase(origins.begin(), origins.begin() + amount);
+		x_axes.erase(x_axes.begin(), x_axes.begin() + amount);
+		y_axes.erase(y_axes.begin(), y_axes.begin() + amount);
+		velocities.erase(velocities.begin(), velocities.begin() + amount);
+		lifetimes.erase(lifetimes.begin(), lifetimes.begin() + amount);
+		cycles.erase(cycles.begin(), cycles.begin() + amount);
+		shape_indices.erase(shape_indices.begin(), shape_indices.begin() + amount);
+		item_rids.erase(item_rids.begin(), item_rids.begin() + amount);
+		if(!data.empty()) {
+			data.erase(data.begin(), data.begin() + amount);
+		}
+		for(int32_t i = 0; i < (int32_t)custom_columns.size(); i++) {
+			custom_columns[i].erase_front(amount);
+		}
+		transforms_dirty.erase(transforms_dirty.begin(), transforms_dirty.begin() + amount);
+		faced_velocities.erase(faced_velocities.begin(), faced_velocities.begin() + amount);
+		facing_valid.erase(facing_valid.begin(), facing_valid.begin() + amount);
+		animation_phases.erase(animation_phases.begin(), animation_phases.begin() + amount);
+		frames.erase(frames.begin(), frames.begin() + amount);
+		drawn_frames.erase(drawn_frames.begin(), drawn_frames.begin() + amount);
+	}
+
+	void swap(int32_t a, int32_t b) {
+		std::swap(origins[a], origins[b]);
+		std::swap(x_axes[a], x_axes[b]);
+		std::swap(y_axes[a], y_axes[b]);
+		std::swap(velocities[a], velocities[b]);
+		std::swap(lifetimes[a], lifetimes[b]);
+		std::swap(cycles[a], cycles[b]);
+		std::swap(shape_indices[a], shape_indices[b]);
+		std::swap(item_rids[a], item_rids[b]);
+		if(!data.empty()) {
+			std::swap(data[a], data[b]);
+		}
+		for(int32_t i = 0; i < (int32_t)custom_columns.size(); i++) {
+			custom_columns[i].swap(a, b);
+		}
+		std::swap(transforms_dirty[a], transforms_dirty[b]);
+		std::swap(faced_velocities[a], faced_velocities[b]);
+		std::swap(facing_valid[a], facing_valid[b]);
+		std::swap(animation_phases[a], animation_phases[b]);
+		std::swap(frames[a], frames[b]);
+		std::swap(drawn_frames[a], drawn_frames[b]);
+	}
+
+	Variant get_data(int32_t index) const {
+		return data.empty() ? Variant() : data[index];
+	}
+
+	void set_data(int32_t index, const Variant& value) {
+		if(data.empty()) {
+			if(value.get_type() == Variant::NIL) {
+				return;
+			}
+			data.resize(origins.size());
+		}
+		data[index] = value;
+	}
+
+	// Gives the custom fields of a bullet their default values.
+	void reset_custom_fields(int32_t index) {
+		for(int32_t i = 0; i < (int32_t)custom_columns.size(); i++) {
+			custom_columns[i].reset(index);
+		}
+	}
+
+	Transform2D get_transform(int32_t index) const {
+		Transform2D transform;
+		transform.elements[0] = x_axes[index];
+		transform.elements[1] = y_axes[index];
+		transform.elements[2] = origins[index];
+		return transform;
+	}
+
+	void set_transform(int32_t index, const Transform2D& transform) {
+		x_axes[index] = transform.elements[0];
+		y_axes[index] = transform.elements[1];
+		origins[index] = transform.elements[2];
+		transforms_dirty[index] = 1;
+		facing_valid[index] = 0;
+	}
+
+	float get_rotation(int32_t index) const {
+		return get_transform(index).get_rotation();
+	}
+
+	void set_rotation(int32_t index, float rotation) {
+		Transform2D transform = get_transform(index);
+		transform.set_rotation(rotation);
+		set_transform(index, transform);
+	}
+
+	// Same as set_rotation, with the rotation given as the unit vector the x axis has to point to.
+	void set_direction(int32_t index, const Vector2& direction) {
+		Vector2& x_axis = x_axes[index];
+		Vector2& y_axis = y_axes[index];
+		float scale_x = x_axis.length();
+		float scale_y = x_axis.cross(y_axis) < 0.0f ? -y_axis.length() : y_axis.length();
+		x_axis = direction * scale_x;
+		y_axis = Vector2(-direction.y, direction.x) * scale_y;
+		transforms_dirty[index] = 1;
+	}
+
+	// Same as set_rotation(index, velocity.angle()), without trigonometry.
+	// The basis is only rebuilt when the direction of the velocity changed since the last call,
+	// bullets flying straight or only changing speed don't have to be rotated again.
+	void face_velocity(int32_t index) {
+		const Vector2& velocity = velocities[index];
+		Vector2& faced = faced_velocities[index];
+		if(facing_valid[index]) {
+			if(velocity == faced) {
+				return;
+			}
+			// Parallel if the sine of the angle between the two is negligible.
+			float cross = faced.cross(velocity);
+			if(faced.dot(velocity) > 0.0f && cross * cross <= 1e-12f * faced.length_squared() * velocity.length_squared()) {
+				return;
+			}
+		}
+		float length = velocity.length();
+		set_direction(index, length > 0.0f ? velocity / length : Vector2(1.0f, 0.0f));
+		faced = velocity;
+		facing_valid[index] = 1;
+	}
+};
+
+// Script-facing view of a bullet living inside a pool.
+// Bullets are not objects themselves, pools create a view only when a bullet has to be accessed by name
+// and bind it to the storage of the requested bullet.
 class Bullet : public Object {
 	GODOT_CLASS(Bullet, Object)
 
 public:
-	RID item_rid;
-	int32_t cycle = 0;
-	int32_t shape_index = -1;
-	Transform2D transform;
-	Vector2 velocity;
-	float lifetime;
-	Variant data;
+	// Kit specific per-bullet fields, stored by the pool next to the shared ones.
+	// Bullet types that need custom properties define their own Fields struct.
+	struct Fields {};
+
+	BulletsStorage* storage = nullptr;
+	int32_t index = -1;
+	void* fields = nullptr;
+
+	// Typed setter and getter of a property, which pools resolve once by name instead of going through
+	// Object reflection on each access. Bullet types adding properties list them in their own `_get_properties`.
+	struct Property {
+		String name;
+		void (*set)(Bullet* bullet, const Variant& value);
+		Variant (*get)(Bullet* bullet);
+	};
+
+	template <class T, class P, void (T::*Setter)(P), P (T::*Getter)()>
+	static Property _property(const char* name) {
+		Property property;
+		property.name = name;
+		property.set = [](Bullet* bullet, const Variant& value) { (static_cast<T*>(bullet)->*Setter)(value); };
+		property.get = [](Bullet* bullet) -> Variant { return (static_cast<T*>(bullet)->*Getter)(); };
+		return property;
+	}
+
+	// Transform, velocity, lifetime and data have their own accessors in the pools.
+	static std::vector<Property> _get_properties() {
+		std::vector<Property> properties;
+		properties.push_back(_property<Bullet, RID, &Bullet::set_item_rid, &Bullet::get_item_rid>("item_rid"));
+		properties.push_back(_property<Bullet, int32_t, &Bullet::set_cycle, &Bullet::get_cycle>("cycle"));
+		properties.push_back(_property<Bullet, int32_t, &Bullet::set_shape_index, &Bullet::get_shape_index>("shape_index"));
+		properties.push_back(_property<Bullet, float, &Bullet::set_animation_phase, &Bullet::get_animation_phase>("animation_phase"));
+		return properties;
+	}
 
 	void _init() {}
 
-	RID get_item_rid() { return item_rid; }
+	void _bind(BulletsStorage* storage, int32_t index, void* fields) {
+		this->storage = storage;
+		this->index = index;
+		this->fields = fields;
+	}
+
+	RID get_item_rid() { return storage->item_rids[index]; }
 	void set_item_rid(RID value) { ERR_PRINT("Can't edit the item rid of bullets!"); }
 
-	int32_t get_cycle() { return cycle; }
+	int32_t get_cycle() { return storage->cycles[index]; }
 	void set_cycle(int32_t value) { ERR_PRINT("Can't edit the cycle of bullets!"); }
 
-	int32_t get_shape_index() { return shape_index; }
+	int32_t get_shape_index() { return storage->shape_indices[index]; }
 	void set_shape_index(int32_t value) { ERR_PRINT("Can't edit the shape index of bullets!"); }
 
+	Transform2D get_transform() { return storage->get_transform(index); }
+	void set_transform(Transform2D value) { storage->set_transform(index, value); }
+
+	Vector2 get_velocity() { return storage->velocities[index]; }
+	void set_velocity(Vector2 value) { storage->velocities[index] = value; }
+
+	float get_lifetime() { return storage->lifetimes[index]; }
+	void set_lifetime(float value) { storage->lifetimes[index] = value; }
+
+	float get_animation_phase() { return storage->animation_phases[index]; }
+	void set_animation_phase(float value) { storage->animation_phases[index] = value; }
+
+	Variant get_data() { return storage->get_data(index); }
+	void set_data(Variant value) { storage->set_data(index, value); }
+
 	static void _register_methods() {
 		register_property<Bullet, RID>("item_rid", &Bullet::set_item_rid, &Bullet::get_item_rid, RID());
 		register_property<Bullet, int32_t>("cycle", &Bullet::set_cycle, &Bullet::get_cycle, 0);
 		register_property<Bullet, int32_t>("shape_index", &Bullet::set_shape_index, &Bullet::get_shape_index, 0);
 
-		register_property<Bullet, Transform2D>("transform", &Bullet::transform, Transform2D());
-		register_property<Bullet, Vector2>("velocity", &Bullet::velocity, Vector2());
-		register_property<Bullet, float>("lifetime", &Bullet::lifetime, 0.0f);
-		register_property<Bullet, Variant>("data", &Bullet::data, Variant());
+		register_property<Bullet, Transform2D>("transform", &Bullet::set_transform, &Bullet::get_transform, Transform2D());
+		register_property<Bullet, Vector2>("velocity", &Bullet::set_velocity, &Bullet::get_velocity, Vector2());
+		register_property<Bullet, float>("lifetime", &Bullet::set_lifetime, &Bullet::get_lifetime, 0.0f);
+		register_property<Bullet, float>("animation_phase", &Bullet::set_animation_phase, &Bullet::get_animation_phase, 0.0f);
+		register_property<Bullet, Variant>("data", &Bullet::set_data, &Bullet::get_data, Variant());
 	}
 };
 
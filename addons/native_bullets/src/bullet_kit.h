@@ -43,6 +43,9 @@ public:
 	int32_t collision_layer = 0;
 	int32_t collision_mask = 0;
 	Ref<Shape2D> collision_shape;
+	// Controls how collisions are detected: by the physics server through a shared area,
+	// or natively against the targets registered in Bullets, for circle and rectangle shapes only.
+	int32_t collision_detection = 0;
 	// Controls whether the active rect is automatically set as the viewport visible rect.
 	bool use_viewport_as_active_rect = true;
 	// Controls where the bullets can live, if a bullet exits this rect, it will be removed.
@@ -52,8 +55,23 @@ public:
 	// Allows the ability to have a unique-ish value in each instance of the bullet material.
 	// Can be used to offset the bullets animation by a unique amount to avoid having them animate in sync.
 	int32_t unique_modulate_component = 0;
+	// Controls how bullets are drawn: each with its own canvas item, or the whole pool with a single MultiMesh.
+	// In batched mode the unique modulate value is stored in the instance color, readable as COLOR in the shader.
+	int32_t rendering_mode = 0;
+	// Frames of the texture, laid out in a grid of animation_h_frames by animation_v_frames. 1 disables the animation.
+	// Each bullet shows the frame of its lifetime, batched kits need a material mapping UVs like utils/atlas_texture.gdshader.
+	int32_t animation_frames = 1;
+	int32_t animation_h_frames = 1;
+	int32_t animation_v_frames = 1;
+	float animation_fps = 10.0f;
+	bool animation_loop = true;
+	// Whether each bullet starts the animation at a different time, instead of all of them from the first frame.
+	bool animation_random_phase = false;
 	// Additional data the user can set via the editor.
 	Variant data;
+	// Per bullet fields stored natively by the pool, by name and default value.
+	// Values can be floats, ints, bools, Vector2s or Colors.
+	Dictionary custom_fields;
 
 	void _init() {}
 
@@ -74,6 +92,8 @@ public:
 		register_property<BulletKit, Ref<Shape2D>>("collision_shape", &BulletKit::collision_shape,
 			Ref<Shape2D>(), GODOT_METHOD_RPC_MODE_DISABLED,GODOT_PROPERTY_USAGE_DEFAULT,
 			GODOT_PROPERTY_HINT_RESOURCE_TYPE, "Shape2D");
+		register_property<BulletKit, int32_t>("collision_detection", &BulletKit::collision_detection, 0,
+			GODOT_METHOD_RPC_MODE_DISABLED, GODOT_PROPERTY_USAGE_DEFAULT, GODOT_PROPERTY_HINT_ENUM, "Physics Server,Native");
 		register_property<BulletKit, bool>("use_viewport_as_active_rect", &BulletKit::use_viewport_as_active_rect, true,
 			GODOT_METHOD_RPC_MODE_DISABLED, (godot_property_usage_flags)(GODOT_PROPERTY_USAGE_DEFAULT | GODOT_PROPERTY_USAGE_UPDATE_ALL_IF_MODIFIED),
 			GODOT_PROPERTY_HINT_NONE);
@@ -84,9 +104,25 @@ public:
 			GODOT_PROPERTY_HINT_NONE);
 		register_property<BulletKit, int32_t>("unique_modulate_component", &BulletKit::unique_modulate_component, 0,
 			GODOT_METHOD_RPC_MODE_DISABLED, GODOT_PROPERTY_USAGE_DEFAULT, GODOT_PROPERTY_HINT_ENUM, "None,Red,Green,Blue,Alpha");
+		register_property<BulletKit, int32_t>("rendering_mode", &BulletKit::rendering_mode, 0,
+			GODOT_METHOD_RPC_MODE_DISABLED, GODOT_PROPERTY_USAGE_DEFAULT, GODOT_PROPERTY_HINT_ENUM, "Per Bullet,Batched");
+		register_property<BulletKit, int32_t>("animation_frames", &BulletKit::animation_frames, 1,
+			GODOT_METHOD_RPC_MODE_DISABLED, GODOT_PROPERTY_USAGE_DEFAULT, GODOT_PROPERTY_HINT_RANGE, "1,1024");
+		register_property<BulletKit, int32_t>("animation_h_frames", &BulletKit::animation_h_frames, 1,
+			GODOT_METHOD_RPC_MODE_DISABLED, GODOT_PROPERTY_USAGE_DEFAULT, GODOT_PROPERTY_HINT_RANGE, "1,128");
+		register_property<BulletKit, int32_t>("animation_v_frames", &BulletKit::animation_v_frames, 1,
+			GODOT_METHOD_RPC_MODE_DISABLED, GODOT_PROPERTY_USAGE_DEFAULT, GODOT_PROPERTY_HINT_RANGE, "1,128");
+		register_property<BulletKit, float>("animation_fps", &BulletKit::animation_fps, 10.0f,
+			GODOT_METHOD_RPC_MODE_DISABLED, GODOT_PROPERTY_USAGE_DEFAULT, GODOT_PROPERTY_HINT_RANGE, "0.0,240.0");
+		register_property<BulletKit, bool>("animation_loop", &BulletKit::animation_loop, true,
+			GODOT_METHOD_RPC_MODE_DISABLED, GODOT_PROPERTY_USAGE_DEFAULT);
+		register_property<BulletKit, bool>("animation_random_phase", &BulletKit::animation_random_phase, false,
+			GODOT_METHOD_RPC_MODE_DISABLED, GODOT_PROPERTY_USAGE_DEFAULT);
 		register_property<BulletKit, Variant>("data", &BulletKit::data, Dictionary(),
 			GODOT_METHOD_RPC_MODE_DISABLED, (godot_property_usage_flags)(GODOT_PROPERTY_USAGE_DEFAULT | GODOT_PROPERTY_USAGE_UPDATE_ALL_IF_MODIFIED),
 			GODOT_PROPERTY_HINT_NONE);
+		register_property<BulletKit, Dictionary>("custom_fields", &BulletKit::custom_fields, Dictionary(),
+			GODOT_METHOD_RPC_MODE_DISABLED, GODOT_PROPERTY_USAGE_DEFAULT, GODOT_PROPERTY_HINT_NONE);
 		
 		register_property<BulletKit, String>("bullet_class_name",
 			&BulletKit::_property_setter, &BulletKit::_property_getter, "",
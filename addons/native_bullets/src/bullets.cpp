@@ -6,6 +6,12 @@
 #include <Engine.hpp>
 #include <Font.hpp>
 #include <RegExMatch.hpp>
+#include <Image.hpp>
+#include <ShaderMaterial.hpp>
+#include <Shader.hpp>
+
+#include <algorithm>
+#include <cstring>
 
 #include "bullets.h"
 
@@ -15,13 +21,21 @@ using namespace godot;
 void Bullets::_register_methods() {
 	register_method("_physics_process", &Bullets::_physics_process);
 
+	register_property<Bullets, int32_t>("workers_amount", &Bullets::set_workers_amount, &Bullets::get_workers_amount, 0,
+		GODOT_METHOD_RPC_MODE_DISABLED, GODOT_PROPERTY_USAGE_DEFAULT, GODOT_PROPERTY_HINT_RANGE, "0,64");
+
 	register_method("mount", &Bullets::mount);
 	register_method("unmount", &Bullets::unmount);
 	register_method("get_bullets_environment", &Bullets::get_bullets_environment);
 
 	register_method("spawn_bullet", &Bullets::spawn_bullet);
+	register_method("spawn_bullets", &Bullets::spawn_bullets);
 	register_method("obtain_bullet", &Bullets::obtain_bullet);
+	register_method("obtain_bullet_handle", &Bullets::obtain_bullet_handle);
 	register_method("release_bullet", &Bullets::release_bullet);
+	register_method("release_all", &Bullets::release_all);
+	register_method("release_in_rect", &Bullets::release_in_rect);
+	register_method("release_in_circle", &Bullets::release_in_circle);
 
 	register_method("is_bullet_valid", &Bullets::is_bullet_valid);
 	register_method("is_kit_valid", &Bullets::is_kit_valid);
@@ -33,13 +47,48 @@ void Bullets::_register_methods() {
 
 	register_method("get_total_available_bullets", &Bullets::get_total_available_bullets);
 	register_method("get_total_active_bullets", &Bullets::get_total_active_bullets);
+	register_method("is_warming_up", &Bullets::is_warming_up);
 
 	register_method("is_bullet_existing", &Bullets::is_bullet_existing);
 	register_method("get_bullet_from_shape", &Bullets::get_bullet_from_shape);
+	register_method("get_bullet_handle_from_shape", &Bullets::get_bullet_handle_from_shape);
 	register_method("get_kit_from_bullet", &Bullets::get_kit_from_bullet);
 
 	register_method("set_bullet_property", &Bullets::set_bullet_property);
 	register_method("get_bullet_property", &Bullets::get_bullet_property);
+
+	register_method("set_bullet_transform", &Bullets::set_bullet_transform);
+	register_method("get_bullet_transform", &Bullets::get_bullet_transform);
+	register_method("set_bullet_velocity", &Bullets::set_bullet_velocity);
+	register_method("get_bullet_velocity", &Bullets::get_bullet_velocity);
+	register_method("set_bullet_lifetime", &Bullets::set_bullet_lifetime);
+	register_method("get_bullet_lifetime", &Bullets::get_bullet_lifetime);
+
+	register_method("set_bullets_transforms", &Bullets::set_bullets_transforms);
+	register_method("set_bullets_velocities", &Bullets::set_bullets_velocities);
+	register_method("set_bullets_lifetimes", &Bullets::set_bullets_lifetimes);
+	register_method("get_bullets_positions", &Bullets::get_bullets_positions);
+	register_method("get_bullets_velocities", &Bullets::get_bullets_velocities);
+	register_method("get_bullets_lifetimes", &Bullets::get_bullets_lifetimes);
+
+	register_method("set_bullets_floats", &Bullets::set_bullets_floats);
+	register_method("set_bullets_ints", &Bullets::set_bullets_ints);
+	register_method("set_bullets_vectors", &Bullets::set_bullets_vectors);
+	register_method("set_bullets_colors", &Bullets::set_bullets_colors);
+	register_method("get_bullets_floats", &Bullets::get_bullets_floats);
+	register_method("get_bullets_ints", &Bullets::get_bullets_ints);
+	register_method("get_bullets_vectors", &Bullets::get_bullets_vectors);
+	register_method("get_bullets_colors", &Bullets::get_bullets_colors);
+
+	register_method("query_bullets_in_rect", &Bullets::query_bullets_in_rect);
+	register_method("query_bullets_in_circle", &Bullets::query_bullets_in_circle);
+	register_method("query_bullets_in_capsule", &Bullets::query_bullets_in_capsule);
+
+	register_method("add_collision_target", &Bullets::add_collision_target);
+	register_method("remove_collision_target", &Bullets::remove_collision_target);
+
+	register_signal<Bullets>("bullet_collided", "bullet_id", GODOT_VARIANT_TYPE_INT, "target", GODOT_VARIANT_TYPE_OBJECT);
+	register_signal<Bullets>("pools_ready", Dictionary());
 }
 
 Bullets::Bullets() { }
@@ -63,38 +112,569 @@ void Bullets::_physics_process(float delta) {
 	if(Engine::get_singleton()->is_editor_hint()) {
 		return;
 	}
+	// Pools kept by unmount are only useful to an environment mounted right after it, as when changing scene.
+	if(bullets_environment == nullptr) {
+		if(!pool_sets.empty()) {
+			_free_pools();
+		}
+		return;
+	}
+	if(warming_up) {
+		_warm_up_pools(warm_up_budget);
+	}
+	_process_pools(delta);
+
+	if(pools_shrink_delay > 0.0f) {
+		_shrink_pools(delta);
+	}
+	if(!collision_targets.empty()) {
+		_detect_collisions();
+	}
+	if(!batch_groups.empty()) {
+		_update_batch_groups();
+	}
+}
+
+void Bullets::_process_pools(float delta) {
 	int32_t bullets_variation = 0;
 
+	if(job_system.get_workers_amount() == 0) {
+		for(int32_t i = 0; i < pool_sets.size(); i++) {
+			for(int32_t j = 0; j < pool_sets[i].pools.size(); j++) {
+				bullets_variation = pool_sets[i].pools[j].pool->_process(delta);
+				available_bullets -= bullets_variation;
+				active_bullets += bullets_variation;
+			}
+		}
+		return;
+	}
+	// Pools that can't leave the main thread are processed right away, the others are split in jobs.
+	jobs.clear();
 	for(int32_t i = 0; i < pool_sets.size(); i++) {
 		for(int32_t j = 0; j < pool_sets[i].pools.size(); j++) {
-			bullets_variation = pool_sets[i].pools[j].pool->_process(delta);
-			available_bullets -= bullets_variation;
-			active_bullets += bullets_variation;
+			BulletsPool* pool = pool_sets[i].pools[j].pool.get();
+
+			if(pool->_is_thread_safe()) {
+				int32_t chunks_amount = pool->_begin_process(delta, bullets_per_job);
+				for(int32_t k = 0; k < chunks_amount; k++) {
+					jobs.push_back(std::make_pair(pool, k));
+				}
+			} else {
+				bullets_variation = pool->_process(delta);
+				available_bullets -= bullets_variation;
+				active_bullets += bullets_variation;
+			}
+		}
+	}
+	job_system.run(jobs.size(), [this](int32_t job) {
+		jobs[job].first->_process_chunk(jobs[job].second);
+	});
+
+	// Releases and servers updates happen on the main thread, in the same order as the single threaded processing.
+	for(int32_t i = 0; i < pool_sets.size(); i++) {
+		for(int32_t j = 0; j < pool_sets[i].pools.size(); j++) {
+			BulletsPool* pool = pool_sets[i].pools[j].pool.get();
+
+			if(pool->_is_thread_safe()) {
+				bullets_variation = pool->_end_process();
+				available_bullets -= bullets_variation;
+				active_bullets += bullets_variation;
+			}
+		}
+	}
+}
+
+void Bullets::_detect_collisions() {
+	// Refresh the targets, forgetting the ones whose node has been freed.
+	for(int32_t i = 0; i < (int32_t)collision_targets.size(); i++) {
+		godot_object* object = core_1_1_api->godot_instance_from_id(collision_targets[i].instance_id);
+		if(object == nullptr) {
+			collision_targets.erase(collision_targets.begin() + i);
+			i--;
+			continue;
+		}
+		collision_targets[i].node = godot::detail::get_wrapper<Node2D>(object);
+		collision_targets[i].position = collision_targets[i].node->get_global_position();
+	}
+	collision_hits.clear();
+	for(int32_t i = 0; i < pool_sets.size(); i++) {
+		for(int32_t j = 0; j < pool_sets[i].pools.size(); j++) {
+			pool_sets[i].pools[j].pool->_detect_collisions(collision_targets, collision_hits);
 		}
 	}
+	// Signals are emitted once all the pools have been tested, as handlers may release bullets.
+	// Targets are looked up again before each signal, as previous handlers may have freed them.
+	for(int32_t i = 0; i < (int32_t)collision_hits.size(); i++) {
+		godot_object* object = core_1_1_api->godot_instance_from_id(collision_hits[i].second);
+		if(object == nullptr) {
+			continue;
+		}
+		emit_signal("bullet_collided", _pack_bullet_id(collision_hits[i].first), godot::detail::get_wrapper<Node2D>(object));
+	}
+}
+
+Array Bullets::_query_bullets(const QueryRegion& region, Ref<BulletKit> kit, int32_t collision_layer) {
+	query_results.clear();
+
+	for(int32_t i = 0; i < pool_sets.size(); i++) {
+		for(int32_t j = 0; j < pool_sets[i].pools.size(); j++) {
+			PoolKit& pool_kit = pool_sets[i].pools[j];
+
+			if(kit.is_valid() && pool_kit.bullet_kit.ptr() != kit.ptr()) {
+				continue;
+			}
+			if(collision_layer != 0 && (pool_kit.bullet_kit->collision_layer & collision_layer) == 0) {
+				continue;
+			}
+			pool_kit.pool->query_bullets(region, query_results);
+		}
+	}
+	Array result = Array();
+	result.resize(query_results.size());
+	for(int32_t i = 0; i < (int32_t)query_results.size(); i++) {
+		result[i] = _pack_bullet_id(query_results[i]);
+	}
+	return result;
+}
+
+Array Bullets::query_bullets_in_rect(Rect2 rect, Ref<BulletKit> kit, int32_t collision_layer) {
+	return _query_bullets(QueryRegion::from_rect(rect), kit, collision_layer);
+}
+
+Array Bullets::query_bullets_in_circle(Vector2 center, float radius, Ref<BulletKit> kit, int32_t collision_layer) {
+	return _query_bullets(QueryRegion::from_circle(center, radius), kit, collision_layer);
+}
+
+Array Bullets::query_bullets_in_capsule(Vector2 from, Vector2 to, float radius, Ref<BulletKit> kit, int32_t collision_layer) {
+	return _query_bullets(QueryRegion::from_capsule(from, to, radius), kit, collision_layer);
+}
+
+void Bullets::add_collision_target(Node2D* target, Ref<Shape2D> shape, int32_t collision_mask) {
+	if(target == nullptr || shape.is_null()) {
+		return;
+	}
+	NativeShape native_shape = NativeShape::from_shape(shape);
+	if(native_shape.type == NativeShape::NONE) {
+		ERR_PRINT("Native collisions only support CircleShape2D and RectangleShape2D!");
+		return;
+	}
+	CollisionTarget collision_target;
+	collision_target.instance_id = target->get_instance_id();
+	collision_target.node = target;
+	collision_target.position = target->get_global_position();
+	collision_target.shape = native_shape;
+	collision_target.collision_mask = collision_mask;
+
+	// Adding the same node again updates its shape and mask.
+	for(int32_t i = 0; i < (int32_t)collision_targets.size(); i++) {
+		if(collision_targets[i].instance_id == collision_target.instance_id) {
+			collision_targets[i] = collision_target;
+			return;
+		}
+	}
+	collision_targets.push_back(collision_target);
+}
+
+void Bullets::remove_collision_target(Node2D* target) {
+	if(target == nullptr) {
+		return;
+	}
+	for(int32_t i = 0; i < (int32_t)collision_targets.size(); i++) {
+		if(collision_targets[i].instance_id == target->get_instance_id()) {
+			collision_targets.erase(collision_targets.begin() + i);
+			return;
+		}
+	}
+}
+
+void Bullets::set_workers_amount(int32_t amount) {
+	job_system.set_workers_amount(amount);
+}
+
+int32_t Bullets::get_workers_amount() {
+	return job_system.get_workers_amount();
 }
 
 void Bullets::_clear_rids() {
-	for(int32_t i = 0; i < shared_areas.size(); i++) {
-		Physics2DServer::get_singleton()->area_clear_shapes(shared_areas[i]);
-		Physics2DServer::get_singleton()->free_rid(shared_areas[i]);
+	for(int32_t i = 0; i < pool_sets.size(); i++) {
+		if(pool_sets[i].shared_area.is_valid()) {
+			Physics2DServer::get_singleton()->area_clear_shapes(pool_sets[i].shared_area);
+			Physics2DServer::get_singleton()->free_rid(pool_sets[i].shared_area);
+		}
 	}
 }
 
+void Bullets::_free_pools() {
+	_clear_rids();
+	// Pools are freed before the batch groups they point to.
+	pool_sets.clear();
+	areas_to_pool_set_indices.clear();
+	kits_to_pool_kits.clear();
+	batch_groups.clear();
+	atlases.clear();
+	atlas_enabled = false;
+	warming_up = false;
+}
+
 int32_t Bullets::_get_pool_index(int32_t set_index, int32_t bullet_index) {
 	if(bullet_index >= 0 && set_index >= 0 && set_index < pool_sets.size() && bullet_index < pool_sets[set_index].bullets_amount) {
-		int32_t pool_threshold = pool_sets[set_index].pools[0].size;
-		int32_t pool_index = 0;
+		return pool_sets[set_index].shapes_to_pool_indices[bullet_index];
+	}
+	return -1;
+}
+
+Bullets::PoolKit* Bullets::_get_pool_kit(const Ref<BulletKit>& kit) {
+	auto pool_kit = kits_to_pool_kits.find(kit.ptr());
+	if(pool_kit == kits_to_pool_kits.end()) {
+		return nullptr;
+	}
+	return pool_kit->second;
+}
+
+BulletsPool* Bullets::_get_pool(BulletID id) {
+	int32_t pool_index = _get_pool_index(id.set, id.index);
+	if(pool_index >= 0) {
+		return pool_sets[id.set].pools[pool_index].pool.get();
+	}
+	return nullptr;
+}
 
-		while(bullet_index >= pool_threshold) {
-			pool_index++;
-			pool_threshold += pool_sets[set_index].pools[pool_index].size;
+template<typename Function>
+int32_t Bullets::_for_each_custom_field(const Array& ids, const String& field, bool integer, int32_t width, Function function) {
+	int32_t found = 0;
+	// Consecutive IDs usually belong to the same pool, so the column is only looked up when the pool changes.
+	BulletsPool* last_pool = nullptr;
+	CustomColumn* column = nullptr;
+
+	for(int32_t i = 0; i < ids.size(); i++) {
+		BulletID bullet_id = _unpack_bullet_id(ids[i]);
+		BulletsPool* pool = _get_pool(bullet_id);
+		if(pool == nullptr) {
+			continue;
+		}
+		if(pool != last_pool) {
+			last_pool = pool;
+			column = pool->get_custom_column(field);
+			if(column != nullptr && (column->is_integer() != integer || (!integer && column->width != width))) {
+				ERR_PRINT("The custom field type doesn't match the type of the values!");
+				column = nullptr;
+			}
+		}
+		if(column == nullptr) {
+			continue;
 		}
-		if(pool_index < pool_sets[set_index].pools.size()) {
-			return pool_index;
+		int32_t bullet_index = pool->get_active_bullet_index(bullet_id);
+		if(bullet_index >= 0) {
+			function(column, bullet_index, i);
+			found++;
 		}
 	}
-	return -1;
+	return found;
+}
+
+bool Bullets::_reserve_bullets(PoolKit* pool_kit, int32_t amount) {
+	BulletsPool* pool = pool_kit->pool.get();
+	PoolKitSet& pool_set = pool_sets[pool->set_index];
+	int32_t pool_index = (int32_t)(pool_kit - pool_set.pools.data());
+
+	// Grow the pool until enough bullets are available, the new shapes are added after every other one in the set.
+	// While the set is warming up its last shapes don't exist yet, so it can't grow.
+	while(pool->get_available_bullets() < amount && pool_kit->size < pool_kit->max_size &&
+			pool_set.warm_up_pool == (int32_t)pool_set.pools.size()) {
+		int32_t grow_amount = pool_kit->max_size - pool_kit->size;
+		if(grow_amount > pool_kit->grow_amount) {
+			grow_amount = pool_kit->grow_amount;
+		}
+		int32_t first_shape_index = pool_set.bullets_amount;
+		if(first_shape_index + grow_amount > 0xFFFFFF + 1) {
+			ERR_PRINT("Bullets sharing a collision layer and mask can't be more than 16777215, the pool can't grow!");
+			break;
+		}
+		if((int32_t)pool_set.shapes_cycles.size() < first_shape_index + grow_amount) {
+			pool_set.shapes_cycles.resize(first_shape_index + grow_amount, 0);
+		}
+		pool->grow(first_shape_index, grow_amount, &pool_set.shapes_cycles[first_shape_index]);
+
+		pool_set.bullets_amount += grow_amount;
+		pool_set.shapes_to_pool_indices.resize(pool_set.bullets_amount, pool_index);
+		pool_set.grown_ranges.push_back(std::make_pair(pool_index, grow_amount));
+		pool_set.idle_time = 0.0f;
+		pool_set.shrink_failed_active = -1;
+		pool_kit->size += grow_amount;
+		available_bullets += grow_amount;
+		total_bullets += grow_amount;
+	}
+	return pool->get_available_bullets() > 0;
+}
+
+void Bullets::_shrink_pools(float delta) {
+	for(int32_t i = 0; i < pool_sets.size(); i++) {
+		PoolKitSet& pool_set = pool_sets[i];
+		if(pool_set.grown_ranges.empty()) {
+			continue;
+		}
+		// The last range can go once its pool has been able to do without it for long enough.
+		std::pair<int32_t, int32_t> range = pool_set.grown_ranges.back();
+		PoolKit& pool_kit = pool_set.pools[range.first];
+		int32_t active = pool_kit.pool->get_active_bullets();
+		if(active > pool_kit.size - range.second) {
+			pool_set.idle_time = 0.0f;
+			pool_set.shrink_failed_active = -1;
+			continue;
+		}
+		pool_set.idle_time += delta;
+		// Removing the range tests each of its bullets, after a failure it's only tried again once the pool
+		// has released some bullets, or after another delay.
+		bool retry = pool_set.shrink_failed_active >= 0 && active < pool_set.shrink_failed_active;
+		if(pool_set.idle_time < pools_shrink_delay && !retry) {
+			continue;
+		}
+		// Fails while any of the bullets using the range is active.
+		int32_t first_shape_index = pool_set.bullets_amount - range.second;
+		if(pool_kit.pool->shrink(first_shape_index, range.second, &pool_set.shapes_cycles[first_shape_index])) {
+			pool_set.bullets_amount = first_shape_index;
+			pool_set.shapes_to_pool_indices.resize(first_shape_index);
+			pool_set.grown_ranges.pop_back();
+			pool_set.idle_time = 0.0f;
+			pool_set.shrink_failed_active = -1;
+			pool_kit.size -= range.second;
+			available_bullets -= range.second;
+			total_bullets -= range.second;
+		} else {
+			pool_set.idle_time = 0.0f;
+			pool_set.shrink_failed_active = active;
+		}
+	}
+}
+
+bool Bullets::_warm_up_pools(int64_t budget) {
+	int64_t start = OS::get_singleton()->get_ticks_usec();
+
+	for(int32_t i = 0; i < pool_sets.size(); i++) {
+		PoolKitSet& pool_set = pool_sets[i];
+
+		while(pool_set.warm_up_pool < (int32_t)pool_set.pools.size()) {
+			PoolKit& pool_kit = pool_set.pools[pool_set.warm_up_pool];
+			int32_t created = pool_kit.pool->pool_size;
+			if(created >= pool_kit.size) {
+				pool_set.warm_up_pool++;
+				continue;
+			}
+			// At least one slice is created each call, so that warming up always ends.
+			int32_t amount = pool_kit.size - created;
+			if(budget > 0 && amount > warm_up_slice) {
+				amount = warm_up_slice;
+			}
+			int32_t first_shape_index = pool_kit.first_shape_index + created;
+			if((int32_t)pool_set.shapes_cycles.size() < first_shape_index + amount) {
+				pool_set.shapes_cycles.resize(first_shape_index + amount, 0);
+			}
+			pool_kit.pool->grow(first_shape_index, amount, &pool_set.shapes_cycles[first_shape_index]);
+			available_bullets += amount;
+			total_bullets += amount;
+
+			if(budget > 0 && OS::get_singleton()->get_ticks_usec() - start >= budget) {
+				return false;
+			}
+		}
+	}
+	warming_up = false;
+	emit_signal("pools_ready");
+	return true;
+}
+
+bool Bullets::_is_atlas_material(const Ref<Material>& material) {
+	// Only materials reading the texture rect from the instance custom data can draw from an atlas,
+	// they declare it with an enabled `atlas` uniform.
+	ShaderMaterial* shader_material = Object::cast_to<ShaderMaterial>(material.ptr());
+	if(shader_material == nullptr || shader_material->get_shader().is_null() ||
+			!shader_material->get_shader()->has_param("atlas")) {
+		return false;
+	}
+	return shader_material->get_shader_param("atlas");
+}
+
+Ref<ImageTexture> Bullets::_pack_atlas(const std::vector<Ref<Texture>>& textures, int64_t flags, std::vector<Rect2>& rects) {
+	// Shelf packing: textures sorted by height are laid out in rows, with a transparent border against bleeding.
+	const int32_t padding = 1;
+	std::vector<int32_t> order(textures.size());
+	int64_t area = 0;
+	int32_t max_width = 0;
+	for(int32_t i = 0; i < (int32_t)textures.size(); i++) {
+		order[i] = i;
+		int32_t width = textures[i]->get_width() + padding * 2;
+		area += (int64_t)width * (textures[i]->get_height() + padding * 2);
+		max_width = width > max_width ? width : max_width;
+	}
+	std::sort(order.begin(), order.end(), [&textures](int32_t a, int32_t b) {
+		return textures[a]->get_height() > textures[b]->get_height();
+	});
+	int32_t atlas_width = 1;
+	while((int64_t)atlas_width * atlas_width < area || atlas_width < max_width) {
+		atlas_width *= 2;
+	}
+	std::vector<Vector2> positions(textures.size());
+	int32_t x = 0;
+	int32_t y = 0;
+	int32_t row_height = 0;
+	for(int32_t i = 0; i < (int32_t)order.size(); i++) {
+		int32_t width = textures[order[i]]->get_width() + padding * 2;
+		int32_t height = textures[order[i]]->get_height() + padding * 2;
+		if(x + width > atlas_width) {
+			x = 0;
+			y += row_height;
+			row_height = 0;
+		}
+		positions[order[i]] = Vector2(x + padding, y + padding);
+		x += width;
+		row_height = height > row_height ? height : row_height;
+	}
+	int32_t atlas_height = y + row_height;
+
+	Ref<Image> atlas_image = Ref<Image>(Image::_new());
+	atlas_image->create(atlas_width, atlas_height, false, Image::FORMAT_RGBA8);
+	for(int32_t i = 0; i < (int32_t)textures.size(); i++) {
+		Ref<Image> image = textures[i]->get_data();
+		if(image.is_null()) {
+			ERR_PRINT("The texture of a batched kit has no image data, it can't be packed in the atlas!");
+			continue;
+		}
+		if(image->is_compressed()) {
+			image->decompress();
+		}
+		if(image->get_format() != Image::FORMAT_RGBA8) {
+			image->convert(Image::FORMAT_RGBA8);
+		}
+		atlas_image->blit_rect(image, Rect2(0.0f, 0.0f, image->get_width(), image->get_height()), positions[i]);
+	}
+	Vector2 atlas_size = Vector2(atlas_width, atlas_height);
+	rects.resize(textures.size());
+	for(int32_t i = 0; i < (int32_t)textures.size(); i++) {
+		rects[i] = Rect2(positions[i] / atlas_size, textures[i]->get_size() / atlas_size);
+	}
+	Ref<ImageTexture> atlas = Ref<ImageTexture>(ImageTexture::_new());
+	atlas->create_from_image(atlas_image, flags);
+	return atlas;
+}
+
+void Bullets::_build_batch_groups() {
+	batch_groups.clear();
+	atlases.clear();
+
+	// Batched pools whose material can draw from an atlas, and the unique textures of their kits.
+	// The filter flag applies to a whole atlas, so filtered textures are packed apart from the others.
+	std::vector<PoolKit*> batched_pools;
+	std::vector<int32_t> pools_filters;
+	std::vector<int32_t> pools_textures;
+	std::vector<Ref<Texture>> textures[2];
+	for(int32_t i = 0; i < pool_sets.size(); i++) {
+		for(int32_t j = 0; j < pool_sets[i].pools.size(); j++) {
+			PoolKit& pool_kit = pool_sets[i].pools[j];
+			if(pool_kit.bullet_kit->rendering_mode != 1 || !_is_atlas_material(pool_kit.bullet_kit->material)) {
+				continue;
+			}
+			Ref<Texture> texture = pool_kit.bullet_kit->get("texture");
+			int32_t filter = (texture->get_flags() & Texture::FLAG_FILTER) != 0 ? 1 : 0;
+			int32_t texture_index = 0;
+			while(texture_index < (int32_t)textures[filter].size() && textures[filter][texture_index].ptr() != texture.ptr()) {
+				texture_index++;
+			}
+			if(texture_index == (int32_t)textures[filter].size()) {
+				textures[filter].push_back(texture);
+			}
+			batched_pools.push_back(&pool_kit);
+			pools_filters.push_back(filter);
+			pools_textures.push_back(texture_index);
+		}
+	}
+	if(batched_pools.empty()) {
+		return;
+	}
+
+	// Mipmaps and repeat would mix neighbouring textures, only filtering is kept.
+	std::vector<Rect2> atlases_rects[2];
+	RID atlases_rids[2];
+	for(int32_t i = 0; i < 2; i++) {
+		if(!textures[i].empty()) {
+			atlases.push_back(_pack_atlas(textures[i], i == 1 ? Texture::FLAG_FILTER : 0, atlases_rects[i]));
+			atlases_rids[i] = atlases.back()->get_rid();
+		}
+	}
+
+	// Pools with the same material, z index and atlas share a group.
+	for(int32_t i = 0; i < (int32_t)batched_pools.size(); i++) {
+		PoolKit* pool_kit = batched_pools[i];
+		RID material = pool_kit->bullet_kit->material->get_rid();
+		RID atlas = atlases_rids[pools_filters[i]];
+		BatchGroup* batch_group = nullptr;
+		for(int32_t j = 0; j < (int32_t)batch_groups.size(); j++) {
+			if(batch_groups[j]->material == material && batch_groups[j]->z_index == pool_kit->z_index &&
+					batch_groups[j]->atlas == atlas) {
+				batch_group = batch_groups[j].get();
+				break;
+			}
+		}
+		if(batch_group == nullptr) {
+			batch_groups.push_back(std::unique_ptr<BatchGroup>(new BatchGroup()));
+			batch_group = batch_groups.back().get();
+			batch_group->create(get_canvas_item(), material, pool_kit->z_index, atlas);
+		}
+		pool_kit->pool->join_batch_group(batch_group, atlases_rects[pools_filters[i]][pools_textures[i]]);
+	}
+}
+
+void Bullets::_update_batch_groups() {
+	for(int32_t i = 0; i < (int32_t)batch_groups.size(); i++) {
+		BatchGroup& batch_group = *batch_groups[i];
+		if(!batch_group.dirty) {
+			continue;
+		}
+		int32_t instances_amount = 0;
+		for(int32_t j = 0; j < (int32_t)batch_group.pools.size(); j++) {
+			instances_amount += batch_group.pools[j]->get_instances_amount();
+		}
+		batch_group.reserve(instances_amount);
+		{
+			// The write access must be released before the array is sent to the VisualServer.
+			PoolRealArray::Write write = batch_group.instances_data.write();
+			float* data = write.ptr();
+
+			// Pools are drawn one after the other, in the order of the sets.
+			for(int32_t j = 0; j < (int32_t)batch_group.pools.size(); j++) {
+				int32_t floats_amount = batch_group.pools[j]->get_instances_amount() * BatchGroup::instance_floats;
+				if(floats_amount > 0) {
+					PoolRealArray::Read read = batch_group.pools[j]->get_instances_data().read();
+					std::memcpy(data, read.ptr(), floats_amount * sizeof(float));
+					data += floats_amount;
+				}
+			}
+		}
+		VisualServer::get_singleton()->multimesh_set_as_bulk_array(batch_group.multimesh, batch_group.instances_data);
+		VisualServer::get_singleton()->multimesh_set_visible_instances(batch_group.multimesh, instances_amount);
+		batch_group.dirty = false;
+	}
+}
+
+int64_t Bullets::_pack_bullet_id(BulletID id) {
+	if(id.index < 0 || id.set < 0) {
+		return -1;
+	}
+	return ((int64_t)(id.cycle & 0x7FFFFFFF) << 32) | ((int64_t)(id.set & 0xFF) << 24) | (int64_t)(id.index & 0xFFFFFF);
+}
+
+BulletID Bullets::_unpack_bullet_id(const Variant& id) {
+	if(id.get_type() == Variant::INT) {
+		int64_t handle = id;
+		if(handle < 0) {
+			return BulletID(-1, -1, -1);
+		}
+		return BulletID((int32_t)(handle & 0xFFFFFF), (int32_t)((handle >> 32) & 0x7FFFFFFF), (int32_t)((handle >> 24) & 0xFF));
+	}
+	PoolIntArray bullet_id = id.operator PoolIntArray();
+	if(bullet_id.size() < 3) {
+		return BulletID(-1, -1, -1);
+	}
+	return BulletID(bullet_id[0], bullet_id[1], bullet_id[2]);
 }
 
 void Bullets::mount(Node* bullets_environment) {
@@ -111,15 +691,26 @@ void Bullets::mount(Node* bullets_environment) {
 	Array bullet_kits = bullets_environment->get("bullet_kits");
 	Array pools_sizes = bullets_environment->get("pools_sizes");
 	Array z_indices = bullets_environment->get("z_indices");
+	Array max_pools_sizes = bullets_environment->get("max_pools_sizes");
+	pools_shrink_delay = bullets_environment->get("pools_shrink_delay");
+	bool keep_bullets = bullets_environment->get("keep_bullets");
+	bool use_atlas = bullets_environment->get("use_atlas");
+	// Pools drawn by batch groups are bound to the atlas of the previous mount, they are never reused.
+	bool reuse_pools = !use_atlas && !atlas_enabled;
+	atlas_enabled = use_atlas;
+	float warm_up_budget_msec = bullets_environment->get("warm_up_budget");
+	warm_up_budget = (int64_t)(warm_up_budget_msec * 1000.0f);
 
+	// Sets of the previous environment, by collision layer and mask.
+	// Their areas and the pools they start with are reused when the new environment has the same kits at the start.
+	std::vector<PoolKitSet> previous_sets = std::move(pool_sets);
+	std::unordered_map<int64_t, int32_t> previous_layers_masks_to_sets;
+	for(int32_t i = 0; i < (int32_t)previous_sets.size(); i++) {
+		previous_layers_masks_to_sets[previous_sets[i].layer_mask] = i;
+	}
 	pool_sets.clear();
 	areas_to_pool_set_indices.clear();
-	kits_to_set_pool_indices.clear();
-	_clear_rids();
-	shared_areas.clear();
-
-	available_bullets = 0;
-	active_bullets = 0;
+	kits_to_pool_kits.clear();
 
 	Dictionary collision_layers_masks_to_kits;
 	
@@ -131,7 +722,8 @@ void Bullets::mount(Node* bullets_environment) {
 		}
 		// By default add the the BulletKit to a no-collisions list. (layer and mask = 0)
 		int64_t layer_mask = 0;
-		if(kit->collisions_enabled && kit->collision_shape.is_valid()) {
+		// Native collisions don't need a shared area, so those kits stay in the no-collisions list too.
+		if(kit->collisions_enabled && kit->collision_shape.is_valid() && kit->collision_detection == 0) {
 			// If collisions are enabled, add the BulletKit to another list.
 			layer_mask = (int64_t)kit->collision_layer + ((int64_t)kit->collision_mask << 32);
 		}
@@ -148,61 +740,160 @@ void Bullets::mount(Node* bullets_environment) {
 	pool_sets.resize(collision_layers_masks_to_kits.size());
 	
 	Array layer_mask_keys = collision_layers_masks_to_kits.keys();
+	if(layer_mask_keys.size() > 256) {
+		ERR_PRINT("Bullets can't have more than 256 different collision layer and mask combinations, packed IDs will be invalid!");
+	}
 	for(int32_t i = 0; i < layer_mask_keys.size(); i++) {
 		Array kits = collision_layers_masks_to_kits[layer_mask_keys[i]];
 		Ref<BulletKit> first_kit = kits[0];
+		PoolKitSet& pool_set = pool_sets[i];
 
-		pool_sets[i].pools.resize(kits.size());
+		pool_set.layer_mask = layer_mask_keys[i];
+		pool_set.pools.resize(kits.size());
+		pool_set.bullets_amount = 0;
+		pool_set.idle_time = 0.0f;
+		pool_set.shrink_failed_active = -1;
+		pool_set.warm_up_pool = 0;
 
-		RID shared_area = RID();
-		if(layer_mask_keys[i].operator int64_t() != 0) {
-			// This is a collisions-enabled set, create the shared area.
-			shared_area = Physics2DServer::get_singleton()->area_create();
-			Physics2DServer::get_singleton()->area_set_collision_layer(shared_area, first_kit->collision_layer);
-			Physics2DServer::get_singleton()->area_set_collision_mask(shared_area, first_kit->collision_mask);
-			Physics2DServer::get_singleton()->area_set_monitorable(shared_area, true);
-			Physics2DServer::get_singleton()->area_set_space(shared_area, get_world_2d()->get_space());
+		auto previous_set_index = previous_layers_masks_to_sets.find(pool_set.layer_mask);
+		PoolKitSet* previous_set = previous_set_index != previous_layers_masks_to_sets.end() ?
+			&previous_sets[previous_set_index->second] : nullptr;
+		// Amount of pools at the start of the previous set that can be kept as they are.
+		int32_t reused_pools = 0;
+
+		if(previous_set != nullptr) {
+			pool_set.shared_area = previous_set->shared_area;
+			previous_set->shared_area = RID();
 
-			shared_areas.append(shared_area);
-			areas_to_pool_set_indices[shared_area] = i;
+			while(reuse_pools && reused_pools < kits.size() && reused_pools < (int32_t)previous_set->pools.size()) {
+				Ref<BulletKit> kit = kits[reused_pools];
+				PoolKit& previous_pool_kit = previous_set->pools[reused_pools];
+				int32_t kit_index_in_node = bullet_kits.find(kit);
+				int32_t pool_size = pools_sizes[kit_index_in_node];
+				int32_t max_pool_size = max_pools_sizes.size() > kit_index_in_node ? (int32_t)max_pools_sizes[kit_index_in_node] : 0;
+
+				if(previous_pool_kit.bullet_kit.ptr() != kit.ptr() || previous_pool_kit.grow_amount != (pool_size > 0 ? pool_size : 1) ||
+						previous_pool_kit.max_size != (max_pool_size > pool_size ? max_pool_size : pool_size) ||
+						previous_pool_kit.z_index != (int32_t)z_indices[kit_index_in_node]) {
+					break;
+				}
+				reused_pools++;
+			}
+			// Grown ranges are after every pool of the set, they can be kept only if the whole set is.
+			if(!previous_set->grown_ranges.empty() &&
+					(reused_pools != kits.size() || reused_pools != (int32_t)previous_set->pools.size())) {
+				reused_pools = 0;
+			}
+			for(int32_t j = 0; j < reused_pools; j++) {
+				pool_set.pools[j] = std::move(previous_set->pools[j]);
+				pool_set.pools[j].pool->set_index = i;
+				pool_set.bullets_amount += pool_set.pools[j].size;
+				if(!keep_bullets) {
+					pool_set.pools[j].pool->release_all_bullets();
+				}
+			}
+			if(reused_pools == (int32_t)previous_set->pools.size()) {
+				pool_set.bullets_amount = previous_set->bullets_amount;
+				pool_set.grown_ranges = std::move(previous_set->grown_ranges);
+			}
+			pool_set.shapes_to_pool_indices = std::move(previous_set->shapes_to_pool_indices);
+			pool_set.shapes_to_pool_indices.resize(pool_set.bullets_amount);
+			pool_set.shapes_cycles = std::move(previous_set->shapes_cycles);
+
+			// The shapes of the pools that are not reused are the last ones, remove them from the end.
+			// The previous set may have been warming up, so its area can have less shapes than its bullets.
+			if(pool_set.shared_area.is_valid()) {
+				int32_t shapes_amount = Physics2DServer::get_singleton()->area_get_shape_count(pool_set.shared_area);
+				for(int32_t j = shapes_amount - 1; j >= pool_set.bullets_amount; j--) {
+					Physics2DServer::get_singleton()->area_remove_shape(pool_set.shared_area, j);
+				}
+			}
+		} else if(pool_set.layer_mask != 0) {
+			// This is a collisions-enabled set, create the shared area.
+			pool_set.shared_area = Physics2DServer::get_singleton()->area_create();
+			Physics2DServer::get_singleton()->area_set_collision_layer(pool_set.shared_area, first_kit->collision_layer);
+			Physics2DServer::get_singleton()->area_set_collision_mask(pool_set.shared_area, first_kit->collision_mask);
+			Physics2DServer::get_singleton()->area_set_monitorable(pool_set.shared_area, true);
+			Physics2DServer::get_singleton()->area_set_space(pool_set.shared_area, get_world_2d()->get_space());
+		}
+		if(pool_set.shared_area.is_valid()) {
+			areas_to_pool_set_indices[pool_set.shared_area.get_id()] = i;
 		}
-		int32_t pool_set_available_bullets = 0;
 
-		for(int32_t j = 0; j < kits.size(); j++) {
+		for(int32_t j = reused_pools; j < kits.size(); j++) {
 			Ref<BulletKit> kit = kits[j];
-
-			PoolIntArray set_pool_indices = PoolIntArray();
-			set_pool_indices.resize(2);
-			set_pool_indices.set(0, i);
-			set_pool_indices.set(1, j);
-			kits_to_set_pool_indices[kit] = set_pool_indices;
 			
 			int32_t kit_index_in_node = bullet_kits.find(kit);
 			int32_t pool_size = pools_sizes[kit_index_in_node];
 
-			pool_sets[i].pools[j].pool = kit->_create_pool();
-			pool_sets[i].pools[j].bullet_kit = kit;
-			pool_sets[i].pools[j].size = pool_size;
-			pool_sets[i].pools[j].z_index = z_indices[kit_index_in_node];
+			pool_set.pools[j].pool = kit->_create_pool();
+			pool_set.pools[j].bullet_kit = kit;
+			pool_set.pools[j].size = pool_size;
+			pool_set.pools[j].z_index = z_indices[kit_index_in_node];
+			// Pools start from at least one bullet, so that they can always grow.
+			pool_set.pools[j].grow_amount = pool_size > 0 ? pool_size : 1;
+			int32_t max_pool_size = max_pools_sizes.size() > kit_index_in_node ? (int32_t)max_pools_sizes[kit_index_in_node] : 0;
+			pool_set.pools[j].max_size = max_pool_size > pool_size ? max_pool_size : pool_size;
+			pool_set.pools[j].first_shape_index = pool_set.bullets_amount;
+
+			// The pool starts empty, its bullets are created by _warm_up_pools in the range reserved here.
+			pool_set.pools[j].pool->_init(this, pool_set.shared_area, pool_set.bullets_amount,
+				i, kit, 0, z_indices[kit_index_in_node]);
+
+			pool_set.bullets_amount += pool_size;
+			pool_set.shapes_to_pool_indices.resize(pool_set.bullets_amount, j);
+		}
+		if(pool_set.bullets_amount > 0xFFFFFF) {
+			ERR_PRINT("Bullets sharing a collision layer and mask can't be more than 16777215, packed IDs will be invalid!");
+		}
+	}
+	// What is left of the previous sets is not used anymore.
+	for(int32_t i = 0; i < (int32_t)previous_sets.size(); i++) {
+		if(previous_sets[i].shared_area.is_valid()) {
+			Physics2DServer::get_singleton()->area_clear_shapes(previous_sets[i].shared_area);
+			Physics2DServer::get_singleton()->free_rid(previous_sets[i].shared_area);
+		}
+	}
+	previous_sets.clear();
 
-			pool_sets[i].pools[j].pool->_init(this, shared_area, pool_set_available_bullets,
-				i, kit, pool_size, z_indices[kit_index_in_node]);
+	// Pointers to the pools are taken once every set is in place.
+	available_bullets = 0;
+	active_bullets = 0;
+	total_bullets = 0;
+	for(int32_t i = 0; i < pool_sets.size(); i++) {
+		for(int32_t j = 0; j < pool_sets[i].pools.size(); j++) {
+			PoolKit& pool_kit = pool_sets[i].pools[j];
+			kits_to_pool_kits[pool_kit.bullet_kit.ptr()] = &pool_kit;
 
-			pool_set_available_bullets += pool_size;
+			available_bullets += pool_kit.pool->get_available_bullets();
+			active_bullets += pool_kit.pool->get_active_bullets();
+			total_bullets += pool_kit.pool->pool_size;
 		}
-		pool_sets[i].bullets_amount = pool_set_available_bullets;
-		available_bullets += pool_set_available_bullets;
 	}
-	total_bullets = available_bullets;
+	// Groups are built before warming up, so that pools create their instances in the group layout.
+	if(use_atlas) {
+		_build_batch_groups();
+	} else {
+		batch_groups.clear();
+		atlases.clear();
+	}
+	// Without a budget every bullet is created now, otherwise the first slices are, and the pools are usable
+	// with the bullets created so far while the others are created in the next frames.
+	warming_up = true;
+	_warm_up_pools(warm_up_budget);
+	_update_batch_groups();
 }
 
 void Bullets::unmount(Node* bullets_environment) {
 	if(this->bullets_environment == bullets_environment) {
-		pool_sets.clear();
-		areas_to_pool_set_indices.clear();
-		kits_to_set_pool_indices.clear();
-		_clear_rids();
-		shared_areas.clear();
+		// Pools are kept, so that the next environment can reuse the ones it has in common with this one.
+		for(int32_t i = 0; i < pool_sets.size(); i++) {
+			for(int32_t j = 0; j < pool_sets[i].pools.size(); j++) {
+				pool_sets[i].pools[j].pool->release_all_bullets();
+			}
+		}
+		kits_to_pool_kits.clear();
+		_update_batch_groups();
 
 		available_bullets = 0;
 		active_bullets = 0;
@@ -220,48 +911,71 @@ Node* Bullets::get_bullets_environment() {
 }
 
 bool Bullets::spawn_bullet(Ref<BulletKit> kit, Dictionary properties) {
-	if(available_bullets > 0 && kits_to_set_pool_indices.has(kit)) {
-		PoolIntArray set_pool_indices = kits_to_set_pool_indices[kit].operator PoolIntArray();
-		BulletsPool* pool = pool_sets[set_pool_indices[0]].pools[set_pool_indices[1]].pool.get();
-
-		if(pool->get_available_bullets() > 0) {
-			available_bullets -= 1;
-			active_bullets += 1;
+	PoolKit* pool_kit = _get_pool_kit(kit);
+	if(pool_kit != nullptr && _reserve_bullets(pool_kit, 1)) {
+		available_bullets -= 1;
+		active_bullets += 1;
 
-			pool->spawn_bullet(properties);
-			return true;
-		}
+		pool_kit->pool->spawn_bullet(properties);
+		return true;
 	}
 	return false;
 }
 
-Variant Bullets::obtain_bullet(Ref<BulletKit> kit) {
-	if(available_bullets > 0 && kits_to_set_pool_indices.has(kit)) {
-		PoolIntArray set_pool_indices = kits_to_set_pool_indices[kit].operator PoolIntArray();
-		BulletsPool* pool = pool_sets[set_pool_indices[0]].pools[set_pool_indices[1]].pool.get();
+int32_t Bullets::spawn_bullets(Ref<BulletKit> kit, PoolVector2Array positions, PoolVector2Array velocities,
+		PoolRealArray rotations, PoolRealArray lifetimes) {
+	int32_t amount = positions.size();
+	if((velocities.size() > 0 && velocities.size() < amount) || (rotations.size() > 0 && rotations.size() < amount) ||
+			(lifetimes.size() > 0 && lifetimes.size() < amount)) {
+		ERR_PRINT("Bullets arrays must be either empty or as long as the positions array!");
+		return 0;
+	}
+	PoolKit* pool_kit = _get_pool_kit(kit);
+	if(pool_kit != nullptr && _reserve_bullets(pool_kit, amount)) {
+		BulletsPool* pool = pool_kit->pool.get();
+
+		int32_t spawned = pool->spawn_bullets(positions, velocities, rotations, lifetimes);
+		available_bullets -= spawned;
+		active_bullets += spawned;
+		return spawned;
+	}
+	return 0;
+}
 
-		if(pool->get_available_bullets() > 0) {
-			available_bullets -= 1;
-			active_bullets += 1;
+Variant Bullets::obtain_bullet(Ref<BulletKit> kit) {
+	PoolKit* pool_kit = _get_pool_kit(kit);
+	if(pool_kit != nullptr && _reserve_bullets(pool_kit, 1)) {
+		available_bullets -= 1;
+		active_bullets += 1;
 
-			BulletID bullet_id = pool->obtain_bullet();
-			PoolIntArray to_return = invalid_id;
-			to_return.set(0, bullet_id.index);
-			to_return.set(1, bullet_id.cycle);
-			to_return.set(2, bullet_id.set);
-			return to_return;
-		}
+		BulletID bullet_id = pool_kit->pool->obtain_bullet();
+		PoolIntArray to_return = invalid_id;
+		to_return.set(0, bullet_id.index);
+		to_return.set(1, bullet_id.cycle);
+		to_return.set(2, bullet_id.set);
+		return to_return;
 	}
 	return invalid_id;
 }
 
+int64_t Bullets::obtain_bullet_handle(Ref<BulletKit> kit) {
+	PoolKit* pool_kit = _get_pool_kit(kit);
+	if(pool_kit != nullptr && _reserve_bullets(pool_kit, 1)) {
+		available_bullets -= 1;
+		active_bullets += 1;
+
+		return _pack_bullet_id(pool_kit->pool->obtain_bullet());
+	}
+	return -1;
+}
+
 bool Bullets::release_bullet(Variant id) {
-	PoolIntArray bullet_id = id.operator PoolIntArray();
+	BulletID bullet_id = _unpack_bullet_id(id);
 	bool result = false;
 
-	int32_t pool_index = _get_pool_index(bullet_id[2], bullet_id[0]);
+	int32_t pool_index = _get_pool_index(bullet_id.set, bullet_id.index);
 	if(pool_index >= 0) {
-		result = pool_sets[bullet_id[2]].pools[pool_index].pool->release_bullet(BulletID(bullet_id[0], bullet_id[1], bullet_id[2]));
+		result = pool_sets[bullet_id.set].pools[pool_index].pool->release_bullet(bullet_id);
 		if(result) {
 			available_bullets += 1;
 			active_bullets -= 1;
@@ -270,48 +984,91 @@ bool Bullets::release_bullet(Variant id) {
 	return result;
 }
 
+int32_t Bullets::release_all(Ref<BulletKit> kit) {
+	int32_t released = 0;
+
+	if(kit.is_valid()) {
+		PoolKit* pool_kit = _get_pool_kit(kit);
+		if(pool_kit != nullptr) {
+			released = pool_kit->pool->release_all_bullets();
+		}
+	} else {
+		for(int32_t i = 0; i < pool_sets.size(); i++) {
+			for(int32_t j = 0; j < pool_sets[i].pools.size(); j++) {
+				released += pool_sets[i].pools[j].pool->release_all_bullets();
+			}
+		}
+	}
+	available_bullets += released;
+	active_bullets -= released;
+	_update_batch_groups();
+	return released;
+}
+
+int32_t Bullets::release_in_rect(Rect2 rect) {
+	return _release_bullets_in(QueryRegion::from_rect(rect));
+}
+
+int32_t Bullets::release_in_circle(Vector2 center, float radius) {
+	return _release_bullets_in(QueryRegion::from_circle(center, radius));
+}
+
+int32_t Bullets::_release_bullets_in(const QueryRegion& region) {
+	int32_t released = 0;
+
+	for(int32_t i = 0; i < pool_sets.size(); i++) {
+		for(int32_t j = 0; j < pool_sets[i].pools.size(); j++) {
+			released += pool_sets[i].pools[j].pool->release_bullets_in(region);
+		}
+	}
+	available_bullets += released;
+	active_bullets -= released;
+	_update_batch_groups();
+	return released;
+}
+
 bool Bullets::is_bullet_valid(Variant id) {
-	PoolIntArray bullet_id = id.operator PoolIntArray();
+	BulletID bullet_id = _unpack_bullet_id(id);
 
-	int32_t pool_index = _get_pool_index(bullet_id[2], bullet_id[0]);
+	int32_t pool_index = _get_pool_index(bullet_id.set, bullet_id.index);
 	if(pool_index >= 0) {
-		return pool_sets[bullet_id[2]].pools[pool_index].pool->is_bullet_valid(BulletID(bullet_id[0], bullet_id[1], bullet_id[2]));
+		return pool_sets[bullet_id.set].pools[pool_index].pool->is_bullet_valid(bullet_id);
 	}
 	return false;
 }
 
 bool Bullets::is_kit_valid(Ref<BulletKit> kit) {
-	return kits_to_set_pool_indices.has(kit);
+	return _get_pool_kit(kit) != nullptr;
 }
 
 int32_t Bullets::get_available_bullets(Ref<BulletKit> kit) {
-	if(kits_to_set_pool_indices.has(kit)) {
-		PoolIntArray set_pool_indices = kits_to_set_pool_indices[kit];
-		return pool_sets[set_pool_indices[0]].pools[set_pool_indices[1]].pool->get_available_bullets();
+	PoolKit* pool_kit = _get_pool_kit(kit);
+	if(pool_kit != nullptr) {
+		return pool_kit->pool->get_available_bullets();
 	}
 	return 0;
 }
 
 int32_t Bullets::get_active_bullets(Ref<BulletKit> kit) {
-	if(kits_to_set_pool_indices.has(kit)) {
-		PoolIntArray set_pool_indices = kits_to_set_pool_indices[kit];
-		return pool_sets[set_pool_indices[0]].pools[set_pool_indices[1]].pool->get_active_bullets();
+	PoolKit* pool_kit = _get_pool_kit(kit);
+	if(pool_kit != nullptr) {
+		return pool_kit->pool->get_active_bullets();
 	}
 	return 0;
 }
 
 int32_t Bullets::get_pool_size(Ref<BulletKit> kit) {
-	if(kits_to_set_pool_indices.has(kit)) {
-		PoolIntArray set_pool_indices = kits_to_set_pool_indices[kit];
-		return pool_sets[set_pool_indices[0]].pools[set_pool_indices[1]].size;
+	PoolKit* pool_kit = _get_pool_kit(kit);
+	if(pool_kit != nullptr) {
+		return pool_kit->size;
 	}
 	return 0;
 }
 
 int32_t Bullets::get_z_index(Ref<BulletKit> kit) {
-	if(kits_to_set_pool_indices.has(kit)) {
-		PoolIntArray set_pool_indices = kits_to_set_pool_indices[kit];
-		return pool_sets[set_pool_indices[0]].pools[set_pool_indices[1]].z_index;
+	PoolKit* pool_kit = _get_pool_kit(kit);
+	if(pool_kit != nullptr) {
+		return pool_kit->z_index;
 	}
 	return 0;
 }
@@ -324,11 +1081,16 @@ int32_t Bullets::get_total_active_bullets() {
 	return active_bullets;
 }
 
+bool Bullets::is_warming_up() {
+	return warming_up;
+}
+
 bool Bullets::is_bullet_existing(RID area_rid, int32_t shape_index) {
-	if(!areas_to_pool_set_indices.has(area_rid)) {
+	auto area_set = areas_to_pool_set_indices.find(area_rid.get_id());
+	if(area_set == areas_to_pool_set_indices.end()) {
 		return false;
 	}
-	int32_t set_index = areas_to_pool_set_indices[area_rid];
+	int32_t set_index = area_set->second;
 	int32_t pool_index = _get_pool_index(set_index, shape_index);
 	if(pool_index >= 0) {
 		return pool_sets[set_index].pools[pool_index].pool->is_bullet_existing(shape_index);
@@ -337,10 +1099,11 @@ bool Bullets::is_bullet_existing(RID area_rid, int32_t shape_index) {
 }
 
 Variant Bullets::get_bullet_from_shape(RID area_rid, int32_t shape_index) {
-	if(!areas_to_pool_set_indices.has(area_rid)) {
+	auto area_set = areas_to_pool_set_indices.find(area_rid.get_id());
+	if(area_set == areas_to_pool_set_indices.end()) {
 		return invalid_id;
 	}
-	int32_t set_index = areas_to_pool_set_indices[area_rid];
+	int32_t set_index = area_set->second;
 	int32_t pool_index = _get_pool_index(set_index, shape_index);
 	if(pool_index >= 0) {
 		BulletID result = pool_sets[set_index].pools[pool_index].pool->get_bullet_from_shape(shape_index);
@@ -354,31 +1117,275 @@ Variant Bullets::get_bullet_from_shape(RID area_rid, int32_t shape_index) {
 	return invalid_id;
 }
 
+int64_t Bullets::get_bullet_handle_from_shape(RID area_rid, int32_t shape_index) {
+	auto area_set = areas_to_pool_set_indices.find(area_rid.get_id());
+	if(area_set == areas_to_pool_set_indices.end()) {
+		return -1;
+	}
+	int32_t set_index = area_set->second;
+	int32_t pool_index = _get_pool_index(set_index, shape_index);
+	if(pool_index >= 0) {
+		return _pack_bullet_id(pool_sets[set_index].pools[pool_index].pool->get_bullet_from_shape(shape_index));
+	}
+	return -1;
+}
+
 Ref<BulletKit> Bullets::get_kit_from_bullet(Variant id) {
-	PoolIntArray bullet_id = id.operator PoolIntArray();
+	BulletID bullet_id = _unpack_bullet_id(id);
 
-	int32_t pool_index = _get_pool_index(bullet_id[2], bullet_id[0]);
-	if(pool_index >= 0 && pool_sets[bullet_id[2]].pools[pool_index].pool->is_bullet_valid(BulletID(bullet_id[0], bullet_id[1], bullet_id[2]))) {
-		return pool_sets[bullet_id[2]].pools[pool_index].bullet_kit;
+	int32_t pool_index = _get_pool_index(bullet_id.set, bullet_id.index);
+	if(pool_index >= 0 && pool_sets[bullet_id.set].pools[pool_index].pool->is_bullet_valid(bullet_id)) {
+		return pool_sets[bullet_id.set].pools[pool_index].bullet_kit;
 	}
 	return Ref<BulletKit>();
 }
 
 void Bullets::set_bullet_property(Variant id, String property, Variant value) {
-	PoolIntArray bullet_id = id.operator PoolIntArray();
+	BulletID bullet_id = _unpack_bullet_id(id);
 
-	int32_t pool_index = _get_pool_index(bullet_id[2], bullet_id[0]);
+	int32_t pool_index = _get_pool_index(bullet_id.set, bullet_id.index);
 	if(pool_index >= 0) {
-		pool_sets[bullet_id[2]].pools[pool_index].pool->set_bullet_property(BulletID(bullet_id[0], bullet_id[1], bullet_id[2]), property, value);
+		pool_sets[bullet_id.set].pools[pool_index].pool->set_bullet_property(bullet_id, property, value);
 	}
 }
 
 Variant Bullets::get_bullet_property(Variant id, String property) {
-	PoolIntArray bullet_id = id.operator PoolIntArray();
+	BulletID bullet_id = _unpack_bullet_id(id);
 
-	int32_t pool_index = _get_pool_index(bullet_id[2], bullet_id[0]);
+	int32_t pool_index = _get_pool_index(bullet_id.set, bullet_id.index);
 	if(pool_index >= 0) {
-		return pool_sets[bullet_id[2]].pools[pool_index].pool->get_bullet_property(BulletID(bullet_id[0], bullet_id[1], bullet_id[2]), property);
+		return pool_sets[bullet_id.set].pools[pool_index].pool->get_bullet_property(bullet_id, property);
 	}
 	return Variant();
+}
+
+bool Bullets::set_bullet_transform(Variant id, Transform2D transform) {
+	BulletID bullet_id = _unpack_bullet_id(id);
+	BulletsPool* pool = _get_pool(bullet_id);
+	return pool != nullptr && pool->set_bullet_transform(bullet_id, transform);
+}
+
+Transform2D Bullets::get_bullet_transform(Variant id) {
+	BulletID bullet_id = _unpack_bullet_id(id);
+	BulletsPool* pool = _get_pool(bullet_id);
+	return pool != nullptr ? pool->get_bullet_transform(bullet_id) : Transform2D();
+}
+
+bool Bullets::set_bullet_velocity(Variant id, Vector2 velocity) {
+	BulletID bullet_id = _unpack_bullet_id(id);
+	BulletsPool* pool = _get_pool(bullet_id);
+	return pool != nullptr && pool->set_bullet_velocity(bullet_id, velocity);
+}
+
+Vector2 Bullets::get_bullet_velocity(Variant id) {
+	BulletID bullet_id = _unpack_bullet_id(id);
+	BulletsPool* pool = _get_pool(bullet_id);
+	return pool != nullptr ? pool->get_bullet_velocity(bullet_id) : Vector2();
+}
+
+bool Bullets::set_bullet_lifetime(Variant id, float lifetime) {
+	BulletID bullet_id = _unpack_bullet_id(id);
+	BulletsPool* pool = _get_pool(bullet_id);
+	return pool != nullptr && pool->set_bullet_lifetime(bullet_id, lifetime);
+}
+
+float Bullets::get_bullet_lifetime(Variant id) {
+	BulletID bullet_id = _unpack_bullet_id(id);
+	BulletsPool* pool = _get_pool(bullet_id);
+	return pool != nullptr ? pool->get_bullet_lifetime(bullet_id) : 0.0f;
+}
+
+int32_t Bullets::set_bullets_transforms(Array ids, PoolVector2Array positions, PoolRealArray rotations) {
+	int32_t amount = ids.size();
+	if(positions.size() < amount || (rotations.size() > 0 && rotations.size() < amount)) {
+		ERR_PRINT("Bullets arrays must be as long as the IDs array, rotations can be empty!");
+		return 0;
+	}
+	PoolVector2Array::Read positions_read = positions.read();
+	PoolRealArray::Read rotations_read = rotations.read();
+	bool has_rotations = rotations.size() > 0;
+	int32_t applied = 0;
+
+	for(int32_t i = 0; i < amount; i++) {
+		BulletID bullet_id = _unpack_bullet_id(ids[i]);
+		BulletsPool* pool = _get_pool(bullet_id);
+		if(pool != nullptr && pool->set_bullet_transform(bullet_id,
+				Transform2D(has_rotations ? rotations_read[i] : 0.0f, positions_read[i]))) {
+			applied++;
+		}
+	}
+	return applied;
+}
+
+int32_t Bullets::set_bullets_velocities(Array ids, PoolVector2Array velocities) {
+	int32_t amount = ids.size();
+	if(velocities.size() < amount) {
+		ERR_PRINT("Bullets arrays must be as long as the IDs array!");
+		return 0;
+	}
+	PoolVector2Array::Read velocities_read = velocities.read();
+	int32_t applied = 0;
+
+	for(int32_t i = 0; i < amount; i++) {
+		BulletID bullet_id = _unpack_bullet_id(ids[i]);
+		BulletsPool* pool = _get_pool(bullet_id);
+		if(pool != nullptr && pool->set_bullet_velocity(bullet_id, velocities_read[i])) {
+			applied++;
+		}
+	}
+	return applied;
+}
+
+int32_t Bullets::set_bullets_lifetimes(Array ids, PoolRealArray lifetimes) {
+	int32_t amount = ids.size();
+	if(lifetimes.size() < amount) {
+		ERR_PRINT("Bullets arrays must be as long as the IDs array!");
+		return 0;
+	}
+	PoolRealArray::Read lifetimes_read = lifetimes.read();
+	int32_t applied = 0;
+
+	for(int32_t i = 0; i < amount; i++) {
+		BulletID bullet_id = _unpack_bullet_id(ids[i]);
+		BulletsPool* pool = _get_pool(bullet_id);
+		if(pool != nullptr && pool->set_bullet_lifetime(bullet_id, lifetimes_read[i])) {
+			applied++;
+		}
+	}
+	return applied;
+}
+
+PoolVector2Array Bullets::get_bullets_positions(Array ids) {
+	PoolVector2Array result = PoolVector2Array();
+	result.resize(ids.size());
+	PoolVector2Array::Write result_write = result.write();
+
+	for(int32_t i = 0; i < ids.size(); i++) {
+		BulletID bullet_id = _unpack_bullet_id(ids[i]);
+		BulletsPool* pool = _get_pool(bullet_id);
+		result_write[i] = pool != nullptr ? pool->get_bullet_transform(bullet_id).get_origin() : Vector2();
+	}
+	return result;
+}
+
+PoolVector2Array Bullets::get_bullets_velocities(Array ids) {
+	PoolVector2Array result = PoolVector2Array();
+	result.resize(ids.size());
+	PoolVector2Array::Write result_write = result.write();
+
+	for(int32_t i = 0; i < ids.size(); i++) {
+		BulletID bullet_id = _unpack_bullet_id(ids[i]);
+		BulletsPool* pool = _get_pool(bullet_id);
+		result_write[i] = pool != nullptr ? pool->get_bullet_velocity(bullet_id) : Vector2();
+	}
+	return result;
+}
+
+PoolRealArray Bullets::get_bullets_lifetimes(Array ids) {
+	PoolRealArray result = PoolRealArray();
+	result.resize(ids.size());
+	PoolRealArray::Write result_write = result.write();
+
+	for(int32_t i = 0; i < ids.size(); i++) {
+		BulletID bullet_id = _unpack_bullet_id(ids[i]);
+		BulletsPool* pool = _get_pool(bullet_id);
+		result_write[i] = pool != nullptr ? pool->get_bullet_lifetime(bullet_id) : 0.0f;
+	}
+	return result;
+}
+
+int32_t Bullets::set_bullets_floats(Array ids, String field, PoolRealArray values) {
+	if(values.size() < ids.size()) {
+		ERR_PRINT("Bullets arrays must be as long as the IDs array!");
+		return 0;
+	}
+	PoolRealArray::Read values_read = values.read();
+	return _for_each_custom_field(ids, field, false, 1, [&values_read](CustomColumn* column, int32_t bullet_index, int32_t i) {
+		column->set_real(bullet_index, values_read[i]);
+	});
+}
+
+int32_t Bullets::set_bullets_ints(Array ids, String field, PoolIntArray values) {
+	if(values.size() < ids.size()) {
+		ERR_PRINT("Bullets arrays must be as long as the IDs array!");
+		return 0;
+	}
+	PoolIntArray::Read values_read = values.read();
+	return _for_each_custom_field(ids, field, true, 1, [&values_read](CustomColumn* column, int32_t bullet_index, int32_t i) {
+		column->set_integer(bullet_index, values_read[i]);
+	});
+}
+
+int32_t Bullets::set_bullets_vectors(Array ids, String field, PoolVector2Array values) {
+	if(values.size() < ids.size()) {
+		ERR_PRINT("Bullets arrays must be as long as the IDs array!");
+		return 0;
+	}
+	PoolVector2Array::Read values_read = values.read();
+	return _for_each_custom_field(ids, field, false, 2, [&values_read](CustomColumn* column, int32_t bullet_index, int32_t i) {
+		column->set_vector2(bullet_index, values_read[i]);
+	});
+}
+
+int32_t Bullets::set_bullets_colors(Array ids, String field, PoolColorArray values) {
+	if(values.size() < ids.size()) {
+		ERR_PRINT("Bullets arrays must be as long as the IDs array!");
+		return 0;
+	}
+	PoolColorArray::Read values_read = values.read();
+	return _for_each_custom_field(ids, field, false, 4, [&values_read](CustomColumn* column, int32_t bullet_index, int32_t i) {
+		column->set_color(bullet_index, values_read[i]);
+	});
+}
+
+PoolRealArray Bullets::get_bullets_floats(Array ids, String field) {
+	PoolRealArray result = PoolRealArray();
+	result.resize(ids.size());
+	PoolRealArray::Write result_write = result.write();
+	for(int32_t i = 0; i < ids.size(); i++) {
+		result_write[i] = 0.0f;
+	}
+	_for_each_custom_field(ids, field, false, 1, [&result_write](CustomColumn* column, int32_t bullet_index, int32_t i) {
+		result_write[i] = column->get_real(bullet_index);
+	});
+	return result;
+}
+
+PoolIntArray Bullets::get_bullets_ints(Array ids, String field) {
+	PoolIntArray result = PoolIntArray();
+	result.resize(ids.size());
+	PoolIntArray::Write result_write = result.write();
+	for(int32_t i = 0; i < ids.size(); i++) {
+		result_write[i] = 0;
+	}
+	_for_each_custom_field(ids, field, true, 1, [&result_write](CustomColumn* column, int32_t bullet_index, int32_t i) {
+		result_write[i] = column->get_integer(bullet_index);
+	});
+	return result;
+}
+
+PoolVector2Array Bullets::get_bullets_vectors(Array ids, String field) {
+	PoolVector2Array result = PoolVector2Array();
+	result.resize(ids.size());
+	PoolVector2Array::Write result_write = result.write();
+	for(int32_t i = 0; i < ids.size(); i++) {
+		result_write[i] = Vector2();
+	}
+	_for_each_custom_field(ids, field, false, 2, [&result_write](CustomColumn* column, int32_t bullet_index, int32_t i) {
+		result_write[i] = column->get_vector2(bullet_index);
+	});
+	return result;
+}
+
+PoolColorArray Bullets::get_bullets_colors(Array ids, String field) {
+	PoolColorArray result = PoolColorArray();
+	result.resize(ids.size());
+	PoolColorArray::Write result_write = result.write();
+	for(int32_t i = 0; i < ids.size(); i++) {
+		result_write[i] = Color();
+	}
+	_for_each_custom_field(ids, field, false, 4, [&result_write](CustomColumn* column, int32_t bullet_index, int32_t i) {
+		result_write[i] = column->get_color(bullet_index);
+	});
+	return result;
 }
\ No newline at end of file
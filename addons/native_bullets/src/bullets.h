@@ -4,6 +4,7 @@
 #include <Godot.hpp>
 #include <Node2D.hpp>
 #include <AtlasTexture.hpp>
+#include <ImageTexture.hpp>
 #include <Material.hpp>
 #include <Color.hpp>
 #include <Array.hpp>
@@ -11,9 +12,11 @@
 
 #include <vector>
 #include <memory>
+#include <unordered_map>
 
 #include "bullet_kit.h"
 #include "bullets_pool.h"
+#include "job_system.h"
 
 using namespace godot;
 
@@ -28,17 +31,39 @@ private:
 		Ref<BulletKit> bullet_kit;
 		int32_t size;
 		int32_t z_index;
+		// The pool grows by its starting size when it runs out of bullets, until it reaches max_size.
+		int32_t grow_amount;
+		int32_t max_size;
+		// First shape index of the range reserved for the pool when it was created.
+		int32_t first_shape_index;
 	};
 	struct PoolKitSet {
 		std::vector<PoolKit> pools;
+		// Collision layer in the lower 32 bits and mask in the upper ones, 0 for the set of pools without shared area.
+		int64_t layer_mask;
+		RID shared_area;
 		int32_t bullets_amount;
+		// Index of the pool owning each shape index of the set.
+		std::vector<int32_t> shapes_to_pool_indices;
+		// Pool index and amount of the shapes added by pools growing, in order.
+		// They are appended at the end of the set, so only the last ones can be removed without renumbering others.
+		std::vector<std::pair<int32_t, int32_t>> grown_ranges;
+		// Next cycle of the shapes removed when pools shrink, so that old IDs don't become valid again.
+		std::vector<int32_t> shapes_cycles;
+		// Time the last grown range has been unused.
+		float idle_time;
+		// Active bullets of the pool owning the last range when removing it last failed, -1 if it didn't.
+		int32_t shrink_failed_active;
+		// Index of the first pool that has not created all its bullets yet, pools are filled in order
+		// so that the area shapes are added in the order of their indices.
+		int32_t warm_up_pool;
 	};
 	// PoolKitSets represent PoolKits organized by their shared area.
 	std::vector<PoolKitSet> pool_sets;
-	// Maps each area RID to the corresponding PoolKitSet index.
-	Dictionary areas_to_pool_set_indices;
-	// Maps each BulletKit to the corresponding PoolKit index.
-	Dictionary kits_to_set_pool_indices;
+	// Maps each area RID id to the corresponding PoolKitSet index.
+	std::unordered_map<int32_t, int32_t> areas_to_pool_set_indices;
+	// Maps each BulletKit to the corresponding PoolKit, stable until the next mount.
+	std::unordered_map<BulletKit*, PoolKit*> kits_to_pool_kits;
 
 	Node* bullets_environment = nullptr;
 
@@ -46,11 +71,65 @@ private:
 	int32_t active_bullets = 0;
 	int32_t total_bullets = 0;
 
-	Array shared_areas;
+	// Seconds grown ranges have to be unused before being removed, 0 never removes them.
+	float pools_shrink_delay = 0.0f;
+
+	// Microseconds per frame spent creating the bullets of a mounted environment, 0 creates them all in mount.
+	int64_t warm_up_budget = 0;
+	// Whether some pools have not created all their bullets yet.
+	bool warming_up = false;
+	// Amount of bullets created at once while warming up, the budget is checked between slices.
+	static const int32_t warm_up_slice = 256;
+
 	PoolIntArray invalid_id;
 
+	// Whether the textures of the batched kits are packed in an atlas, so that pools can share their MultiMesh.
+	bool atlas_enabled = false;
+	// Atlases of the mounted environment, filtered and unfiltered textures are packed separately.
+	std::vector<Ref<ImageTexture>> atlases;
+	// Batch groups of the mounted environment, pools keep pointers to them.
+	std::vector<std::unique_ptr<BatchGroup>> batch_groups;
+
+	// Amount of bullets processed by a single job when pools are processed by multiple threads.
+	static const int32_t bullets_per_job = 1024;
+	JobSystem job_system;
+	// Pool and chunk index of each job of the current frame.
+	std::vector<std::pair<BulletsPool*, int32_t>> jobs;
+
+	// Nodes tested against the bullets of kits using native collisions.
+	std::vector<CollisionTarget> collision_targets;
+	// Bullets and target instance IDs of the collisions detected in the current frame.
+	// Handlers may add or remove targets, so the hits don't refer to them by index.
+	std::vector<std::pair<BulletID, int64_t>> collision_hits;
+	// Bullets found by the current region query.
+	std::vector<BulletID> query_results;
+
 	void _clear_rids();
+	void _free_pools();
+	void _process_pools(float delta);
+	void _detect_collisions();
+	Array _query_bullets(const QueryRegion& region, Ref<BulletKit> kit, int32_t collision_layer);
+	int32_t _release_bullets_in(const QueryRegion& region);
 	int32_t _get_pool_index(int32_t set_index, int32_t bullet_index);
+	PoolKit* _get_pool_kit(const Ref<BulletKit>& kit);
+	BulletsPool* _get_pool(BulletID id);
+	// Calls `function(column, bullet_index, i)` for the bullet of each element of `ids` whose kit has a custom field
+	// named `field` stored as integers or as `width` reals. Returns how many bullets were found.
+	template<typename Function>
+	int32_t _for_each_custom_field(const Array& ids, const String& field, bool integer, int32_t width, Function function);
+	bool _reserve_bullets(PoolKit* pool_kit, int32_t amount);
+	void _shrink_pools(float delta);
+	bool _warm_up_pools(int64_t budget);
+	static bool _is_atlas_material(const Ref<Material>& material);
+	// Packs `textures` in a new atlas, storing in `rects` their normalized rect in it.
+	static Ref<ImageTexture> _pack_atlas(const std::vector<Ref<Texture>>& textures, int64_t flags, std::vector<Rect2>& rects);
+	void _build_batch_groups();
+	void _update_batch_groups();
+
+	// Bullet IDs can be a 3 elements PoolIntArray, or a single int packing the same values without allocations:
+	// the shape index in the lowest 24 bits, the set index in the next 8 and the cycle in the upper 31.
+	static int64_t _pack_bullet_id(BulletID id);
+	static BulletID _unpack_bullet_id(const Variant& id);
 
 public:
 	static void _register_methods();
@@ -62,13 +141,22 @@ public:
 
 	void _physics_process(float delta);
 
+	void set_workers_amount(int32_t amount);
+	int32_t get_workers_amount();
+
 	void mount(Node* bullets_environment);
 	void unmount(Node* bullets_environment);
 	Node* get_bullets_environment();
 
 	bool spawn_bullet(Ref<BulletKit> kit, Dictionary properties);
+	int32_t spawn_bullets(Ref<BulletKit> kit, PoolVector2Array positions, PoolVector2Array velocities,
+		PoolRealArray rotations, PoolRealArray lifetimes);
 	Variant obtain_bullet(Ref<BulletKit> kit);
+	int64_t obtain_bullet_handle(Ref<BulletKit> kit);
 	bool release_bullet(Variant id);
+	int32_t release_all(Ref<BulletKit> kit);
+	int32_t release_in_rect(Rect2 rect);
+	int32_t release_in_circle(Vector2 center, float radius);
 
 	bool is_bullet_valid(Variant id);
 	bool is_kit_valid(Ref<BulletKit> kit);
@@ -80,13 +168,45 @@ public:
 
 	int32_t get_total_available_bullets();
 	int32_t get_total_active_bullets();
+	bool is_warming_up();
 
 	bool is_bullet_existing(RID area_rid, int32_t shape_index);
 	Variant get_bullet_from_shape(RID area_rid, int32_t shape_index);
+	int64_t get_bullet_handle_from_shape(RID area_rid, int32_t shape_index);
 	Ref<BulletKit> get_kit_from_bullet(Variant id);
 
 	void set_bullet_property(Variant id, String property, Variant value);
 	Variant get_bullet_property(Variant id, String property);
+
+	bool set_bullet_transform(Variant id, Transform2D transform);
+	Transform2D get_bullet_transform(Variant id);
+	bool set_bullet_velocity(Variant id, Vector2 velocity);
+	Vector2 get_bullet_velocity(Variant id);
+	bool set_bullet_lifetime(Variant id, float lifetime);
+	float get_bullet_lifetime(Variant id);
+
+	int32_t set_bullets_transforms(Array ids, PoolVector2Array positions, PoolRealArray rotations);
+	int32_t set_bullets_velocities(Array ids, PoolVector2Array velocities);
+	int32_t set_bullets_lifetimes(Array ids, PoolRealArray lifetimes);
+	PoolVector2Array get_bullets_positions(Array ids);
+	PoolVector2Array get_bullets_velocities(Array ids);
+	PoolRealArray get_bullets_lifetimes(Array ids);
+
+	int32_t set_bullets_floats(Array ids, String field, PoolRealArray values);
+	int32_t set_bullets_ints(Array ids, String field, PoolIntArray values);
+	int32_t set_bullets_vectors(Array ids, String field, PoolVector2Array values);
+	int32_t set_bullets_colors(Array ids, String field, PoolColorArray values);
+	PoolRealArray get_bullets_floats(Array ids, String field);
+	PoolIntArray get_bullets_ints(Array ids, String field);
+	PoolVector2Array get_bullets_vectors(Array ids, String field);
+	PoolColorArray get_bullets_colors(Array ids, String field);
+
+	Array query_bullets_in_rect(Rect2 rect, Ref<BulletKit> kit, int32_t collision_layer);
+	Array query_bullets_in_circle(Vector2 center, float radius, Ref<BulletKit> kit, int32_t collision_layer);
+	Array query_bullets_in_capsule(Vector2 from, Vector2 to, float radius, Ref<BulletKit> kit, int32_t collision_layer);
+
+	void add_collision_target(Node2D* target, Ref<Shape2D> shape, int32_t collision_mask);
+	void remove_collision_target(Node2D* target);
 };
 
 #endif
\ No newline at end of file
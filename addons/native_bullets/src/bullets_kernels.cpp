@@ -0,0 +1,214 @@
+#include "bullets_kernels.h"
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define BULLETS_KERNELS_X86
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+#elif defined(__aarch64__) || defined(_M_ARM64)
+#define BULLETS_KERNELS_NEON
+#include <arm_neon.h>
+#endif
+
+using namespace godot;
+
+static_assert(sizeof(Vector2) == 2 * sizeof(float), "Kernels expect Vector2 to be made of two packed floats.");
+
+typedef int32_t (*IntegrateBulletsFunction)(Vector2*, const Vector2*, float*, int32_t, float, Rect2, int32_t, int32_t*);
+
+
+static inline int32_t integrate_bullets_scalar(Vector2* origins, const Vector2* velocities, float* lifetimes, int32_t amount,
+		float delta, Rect2 active_rect, int32_t first_index, int32_t* to_release, int32_t start) {
+	Vector2 rect_end = active_rect.position + active_rect.size;
+	int32_t released = 0;
+
+	for(int32_t i = start; i < amount; i++) {
+		Vector2 origin = origins[i] + velocities[i] * delta;
+		origins[i] = origin;
+		lifetimes[i] += delta;
+
+		// Same test as Rect2::has_point.
+		if(origin.x < active_rect.position.x || origin.y < active_rect.position.y ||
+				origin.x >= rect_end.x || origin.y >= rect_end.y) {
+			to_release[released++] = first_index + i;
+		}
+	}
+	return released;
+}
+
+static int32_t integrate_bullets_generic(Vector2* origins, const Vector2* velocities, float* lifetimes, int32_t amount,
+		float delta, Rect2 active_rect, int32_t first_index, int32_t* to_release) {
+	return integrate_bullets_scalar(origins, velocities, lifetimes, amount, delta, active_rect, first_index, to_release, 0);
+}
+
+#if defined(BULLETS_KERNELS_X86)
+
+// Origins and velocities are interleaved, so each 128 bits register holds 2 bullets.
+// `outside` has two bits per bullet, set when its x or y coordinate is outside the rect.
+static inline int32_t append_released(int32_t outside, int32_t bullets_amount, int32_t index, int32_t* to_release) {
+	int32_t released = 0;
+	for(int32_t b = 0; b < bullets_amount; b++) {
+		if(outside & (3 << (b * 2))) {
+			to_release[released++] = index + b;
+		}
+	}
+	return released;
+}
+
+static int32_t integrate_bullets_sse2(Vector2* origins, const Vector2* velocities, float* lifetimes, int32_t amount,
+		float delta, Rect2 active_rect, int32_t first_index, int32_t* to_release) {
+	Vector2 rect_end = active_rect.position + active_rect.size;
+	__m128 delta_4 = _mm_set1_ps(delta);
+	__m128 rect_start_4 = _mm_setr_ps(active_rect.position.x, active_rect.position.y, active_rect.position.x, active_rect.position.y);
+	__m128 rect_end_4 = _mm_setr_ps(rect_end.x, rect_end.y, rect_end.x, rect_end.y);
+	int32_t released = 0;
+	int32_t i = 0;
+
+	// 4 bullets per iteration.
+	for(; i + 4 <= amount; i += 4) {
+		float* origin = (float*)(origins + i);
+		const float* velocity = (const float*)(velocities + i);
+
+		__m128 origin_0 = _mm_add_ps(_mm_loadu_ps(origin), _mm_mul_ps(_mm_loadu_ps(velocity), delta_4));
+		__m128 origin_1 = _mm_add_ps(_mm_loadu_ps(origin + 4), _mm_mul_ps(_mm_loadu_ps(velocity + 4), delta_4));
+		_mm_storeu_ps(origin, origin_0);
+		_mm_storeu_ps(origin + 4, origin_1);
+		_mm_storeu_ps(lifetimes + i, _mm_add_ps(_mm_loadu_ps(lifetimes + i), delta_4));
+
+		__m128 outside_0 = _mm_or_ps(_mm_cmplt_ps(origin_0, rect_start_4), _mm_cmpge_ps(origin_0, rect_end_4));
+		__m128 outside_1 = _mm_or_ps(_mm_cmplt_ps(origin_1, rect_start_4), _mm_cmpge_ps(origin_1, rect_end_4));
+		int32_t outside = _mm_movemask_ps(outside_0) | (_mm_movemask_ps(outside_1) << 4);
+
+		if(outside != 0) {
+			released += append_released(outside, 4, first_index + i, to_release + released);
+		}
+	}
+	return released + integrate_bullets_scalar(origins, velocities, lifetimes, amount,
+		delta, active_rect, first_index, to_release + released, i);
+}
+
+#if defined(_MSC_VER) && !defined(__clang__)
+#define BULLETS_KERNELS_TARGET_AVX
+#else
+#define BULLETS_KERNELS_TARGET_AVX __attribute__((target("avx")))
+#endif
+
+BULLETS_KERNELS_TARGET_AVX
+static int32_t integrate_bullets_avx(Vector2* origins, const Vector2* velocities, float* lifetimes, int32_t amount,
+		float delta, Rect2 active_rect, int32_t first_index, int32_t* to_release) {
+	Vector2 rect_end = active_rect.position + active_rect.size;
+	__m256 delta_8 = _mm256_set1_ps(delta);
+	__m256 rect_start_8 = _mm256_setr_ps(active_rect.position.x, active_rect.position.y, active_rect.position.x, active_rect.position.y,
+		active_rect.position.x, active_rect.position.y, active_rect.position.x, active_rect.position.y);
+	__m256 rect_end_8 = _mm256_setr_ps(rect_end.x, rect_end.y, rect_end.x, rect_end.y,
+		rect_end.x, rect_end.y, rect_end.x, rect_end.y);
+	int32_t released = 0;
+	int32_t i = 0;
+
+	// 8 bullets per iteration.
+	for(; i + 8 <= amount; i += 8) {
+		float* origin = (float*)(origins + i);
+		const float* velocity = (const float*)(velocities + i);
+
+		__m256 origin_0 = _mm256_add_ps(_mm256_loadu_ps(origin), _mm256_mul_ps(_mm256_loadu_ps(velocity), delta_8));
+		__m256 origin_1 = _mm256_add_ps(_mm256_loadu_ps(origin + 8), _mm256_mul_ps(_mm256_loadu_ps(velocity + 8), delta_8));
+		_mm256_storeu_ps(origin, origin_0);
+		_mm256_storeu_ps(origin + 8, origin_1);
+		_mm256_storeu_ps(lifetimes + i, _mm256_add_ps(_mm256_loadu_ps(lifetimes + i), delta_8));
+
+		__m256 outside_0 = _mm256_or_ps(_mm256_cmp_ps(origin_0, rect_start_8, _CMP_LT_OQ), _mm256_cmp_ps(origin_0, rect_end_8, _CMP_GE_OQ));
+		__m256 outside_1 = _mm256_or_ps(_mm256_cmp_ps(origin_1, rect_start_8, _CMP_LT_OQ), _mm256_cmp_ps(origin_1, rect_end_8, _CMP_GE_OQ));
+		int32_t outside = _mm256_movemask_ps(outside_0) | (_mm256_movemask_ps(outside_1) << 8);
+
+		if(outside != 0) {
+			released += append_released(outside, 8, first_index + i, to_release + released);
+		}
+	}
+	_mm256_zeroupper();
+	return released + integrate_bullets_scalar(origins, velocities, lifetimes, amount,
+		delta, active_rect, first_index, to_release + released, i);
+}
+
+static bool is_avx_supported() {
+#if defined(_MSC_VER) && !defined(__clang__)
+	int info[4];
+	__cpuid(info, 1);
+	bool os_uses_xsave = (info[2] & (1 << 27)) != 0;
+	bool cpu_has_avx = (info[2] & (1 << 28)) != 0;
+	// The OS must also save the AVX registers on context switches.
+	return os_uses_xsave && cpu_has_avx && (_xgetbv(0) & 6) == 6;
+#else
+	__builtin_cpu_init();
+	return __builtin_cpu_supports("avx");
+#endif
+}
+
+#elif defined(BULLETS_KERNELS_NEON)
+
+static int32_t integrate_bullets_neon(Vector2* origins, const Vector2* velocities, float* lifetimes, int32_t amount,
+		float delta, Rect2 active_rect, int32_t first_index, int32_t* to_release) {
+	Vector2 rect_end = active_rect.position + active_rect.size;
+	float32x4_t delta_4 = vdupq_n_f32(delta);
+	float rect_start_values[4] = { active_rect.position.x, active_rect.position.y, active_rect.position.x, active_rect.position.y };
+	float rect_end_values[4] = { rect_end.x, rect_end.y, rect_end.x, rect_end.y };
+	float32x4_t rect_start_4 = vld1q_f32(rect_start_values);
+	float32x4_t rect_end_4 = vld1q_f32(rect_end_values);
+	int32_t released = 0;
+	int32_t i = 0;
+
+	// 4 bullets per iteration.
+	for(; i + 4 <= amount; i += 4) {
+		float* origin = (float*)(origins + i);
+		const float* velocity = (const float*)(velocities + i);
+
+		float32x4_t origin_0 = vaddq_f32(vld1q_f32(origin), vmulq_f32(vld1q_f32(velocity), delta_4));
+		float32x4_t origin_1 = vaddq_f32(vld1q_f32(origin + 4), vmulq_f32(vld1q_f32(velocity + 4), delta_4));
+		vst1q_f32(origin, origin_0);
+		vst1q_f32(origin + 4, origin_1);
+		vst1q_f32(lifetimes + i, vaddq_f32(vld1q_f32(lifetimes + i), delta_4));
+
+		uint32x4_t outside_0 = vorrq_u32(vcltq_f32(origin_0, rect_start_4), vcgeq_f32(origin_0, rect_end_4));
+		uint32x4_t outside_1 = vorrq_u32(vcltq_f32(origin_1, rect_start_4), vcgeq_f32(origin_1, rect_end_4));
+		// Pairwise max merges the x and y lanes, leaving one lane per bullet.
+		uint32x4_t outside = vpmaxq_u32(outside_0, outside_1);
+
+		if(vmaxvq_u32(outside) != 0) {
+			uint32_t lanes[4];
+			vst1q_u32(lanes, outside);
+			for(int32_t b = 0; b < 4; b++) {
+				if(lanes[b] != 0) {
+					to_release[released++] = first_index + i + b;
+				}
+			}
+		}
+	}
+	return released + integrate_bullets_scalar(origins, velocities, lifetimes, amount,
+		delta, active_rect, first_index, to_release + released, i);
+}
+
+#endif
+
+static IntegrateBulletsFunction select_integrate_bullets() {
+#if defined(BULLETS_KERNELS_X86)
+	if(is_avx_supported()) {
+		return integrate_bullets_avx;
+	}
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+	return integrate_bullets_sse2;
+#else
+	return integrate_bullets_generic;
+#endif
+#elif defined(BULLETS_KERNELS_NEON)
+	return integrate_bullets_neon;
+#else
+	return integrate_bullets_generic;
+#endif
+}
+
+static const IntegrateBulletsFunction integrate_bullets_function = select_integrate_bullets();
+
+int32_t integrate_bullets(Vector2* origins, const Vector2* velocities, float* lifetimes, int32_t amount,
+		float delta, Rect2 active_rect, int32_t first_index, int32_t* to_release) {
+	return integrate_bullets_function(origins, velocities, lifetimes, amount, delta, active_rect, first_index, to_release);
+}
\ No newline at end of file
@@ -0,0 +1,18 @@
+#ifndef BULLETS_KERNELS_H
+#define BULLETS_KERNELS_H
+
+#include <Godot.hpp>
+#include <Vector2.hpp>
+#include <Rect2.hpp>
+
+using namespace godot;
+
+
+// Moves `amount` bullets by their velocity and increases their lifetime.
+// The indices of the bullets that ended up outside `active_rect` are written to `to_release` in ascending order,
+// offset by `first_index`. Returns how many indices were written.
+// Runs with the widest instruction set supported by the CPU, results don't depend on the one chosen.
+int32_t integrate_bullets(Vector2* origins, const Vector2* velocities, float* lifetimes, int32_t amount,
+	float delta, Rect2 active_rect, int32_t first_index, int32_t* to_release);
+
+#endif
\ No newline at end of file
@@ -13,4 +13,45 @@ int32_t BulletsPool::get_available_bullets() {
 
 int32_t BulletsPool::get_active_bullets() {
 	return active_bullets;
+}
+
+CustomColumn* BulletsPool::get_custom_column(const String& name) {
+	for(int32_t i = 0; i < (int32_t)bullets.custom_columns.size(); i++) {
+		if(bullets.custom_columns[i].name == name) {
+			return &bullets.custom_columns[i];
+		}
+	}
+	return nullptr;
+}
+
+int32_t BulletsPool::_get_property_accessor(const String& property) {
+	for(int32_t i = 0; i < (int32_t)property_accessors.size(); i++) {
+		if(property_accessors[i].first == property) {
+			return property_accessors[i].second;
+		}
+	}
+	int32_t accessor = PROPERTY_OTHER;
+	if(property == "transform") {
+		accessor = PROPERTY_TRANSFORM;
+	} else if(property == "velocity") {
+		accessor = PROPERTY_VELOCITY;
+	} else if(property == "lifetime") {
+		accessor = PROPERTY_LIFETIME;
+	} else if(property == "data") {
+		accessor = PROPERTY_DATA;
+	} else {
+		CustomColumn* column = get_custom_column(property);
+		if(column != nullptr) {
+			accessor = PROPERTY_CUSTOM + (int32_t)(column - bullets.custom_columns.data());
+		} else {
+			for(int32_t i = 0; i < (int32_t)bullet_properties.size(); i++) {
+				if(bullet_properties[i].name == property) {
+					accessor = PROPERTY_BULLET + i;
+					break;
+				}
+			}
+		}
+	}
+	property_accessors.push_back(std::make_pair(property, accessor));
+	return accessor;
 }
\ No newline at end of file
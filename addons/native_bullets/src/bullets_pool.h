@@ -7,8 +7,15 @@
 #include <Material.hpp>
 #include <Color.hpp>
 
+#include <vector>
+#include <algorithm>
+#include <utility>
+#include <cmath>
+
 #include "bullet.h"
 #include "bullet_kit.h"
+#include "native_collisions.h"
+#include "batch_group.h"
 
 using namespace godot;
 
@@ -16,19 +23,105 @@ using namespace godot;
 class BulletsPool {
 	
 protected:
-	int32_t* shapes_to_indices = nullptr;
+	// Index of the bullet owning each shape, relative to starting_shape_index. Shapes of other pools map to -1:
+	// pools that grew own ranges of shapes separated by the ones of other pools.
+	std::vector<int32_t> shapes_to_indices;
 	int32_t available_bullets = 0;
 	int32_t active_bullets = 0;
 	int32_t bullets_to_handle = 0;
+	// Whether the bullets have shapes in the shared area.
 	bool collisions_enabled;
+	// Whether the bullets are tested against the collision targets, using the spatial hash.
+	bool native_collisions = false;
+	NativeShape native_shape;
+	// Index of the active bullets by position, rebuilt when needed after bullets move, spawn or get released.
+	SpatialHash spatial_hash;
+	float spatial_hash_cell_size = 64.0f;
+	bool spatial_hash_dirty = true;
+	// If enabled, the whole pool is drawn by a single MultiMesh instead of a canvas item per bullet.
+	bool batched_rendering = false;
+
+	// Shared state of the bullets in this pool.
+	// Active bullets are kept packed at the end, in the [available_bullets, pool_size) range.
+	BulletsStorage bullets;
+	// Indices of the bullets to release at the end of the current frame.
+	// Each chunk writes them in ascending order, starting from the position of its first bullet.
+	std::vector<int32_t> bullets_to_release;
+	// Indices of the bullets found by the spatial hash for the current region release.
+	std::vector<int32_t> region_candidates;
+	// State of the frame being processed in chunks.
+	float process_delta = 0.0f;
+	int32_t chunk_size = 1;
+	int32_t chunks_begin = 0;
+	std::vector<int32_t> chunks_released;
 
 	CanvasItem* canvas_parent;
 	RID canvas_item;
+	RID multimesh;
+	RID mesh;
 	RID shared_area;
 	int32_t starting_shape_index;
 
 	Rect2 active_rect;
 
+	// Unique modulate color of each bullet, indexed by its shape index relative to the pool.
+	std::vector<Color> modulates;
+	// MultiMesh instances data, a 2D transform and a color for each active bullet.
+	// Pools drawn by a batch group add the rect of the texture in the atlas, see BatchGroup.
+	PoolRealArray instances_data;
+	// Amount of instances written by the last update.
+	int32_t instances_amount = 0;
+	BatchGroup* batch_group = nullptr;
+	Rect2 atlas_rect;
+
+	// Frame animation of the kit texture, read when the pool is created.
+	int32_t animation_frames = 1;
+	int32_t animation_h_frames = 1;
+	int32_t animation_v_frames = 1;
+	float animation_fps = 0.0f;
+	bool animation_loop = true;
+	// Size of a frame in pixels, the whole texture when the kit is not animated.
+	Vector2 frame_size;
+
+	// Instances also hold a texture rect in their custom data when they are drawn from an atlas or animated.
+	int32_t _get_instance_floats() {
+		return batch_group != nullptr || animation_frames > 1 ? BatchGroup::instance_floats : 12;
+	}
+
+	int32_t _get_animation_frame(float time) {
+		int32_t frame = (int32_t)std::floor(time * animation_fps);
+		if(animation_loop) {
+			frame %= animation_frames;
+			return frame < 0 ? frame + animation_frames : frame;
+		}
+		return frame < 0 ? 0 : (frame < animation_frames ? frame : animation_frames - 1);
+	}
+
+	// Rect of `frame` in the texture, in UV coordinates.
+	Rect2 _get_frame_rect(int32_t frame) {
+		Vector2 size = Vector2(1.0f / animation_h_frames, 1.0f / animation_v_frames);
+		return Rect2(Vector2((frame % animation_h_frames) * size.x, (frame / animation_h_frames) * size.y), size);
+	}
+
+	// Accessors of the properties read and written by name, unknown ones go through Object reflection.
+	// PROPERTY_CUSTOM + i accesses the custom column i.
+	enum PropertyAccessor {
+		PROPERTY_OTHER,
+		PROPERTY_TRANSFORM,
+		PROPERTY_VELOCITY,
+		PROPERTY_LIFETIME,
+		PROPERTY_DATA,
+		PROPERTY_CUSTOM,
+		// PROPERTY_BULLET + i accesses the property i of the bullet type.
+		PROPERTY_BULLET = 1 << 16
+	};
+	// Names already resolved to an accessor, scripts usually use a handful of them.
+	std::vector<std::pair<String, int32_t>> property_accessors;
+	// Typed accessors of the other properties of the bullet type.
+	std::vector<Bullet::Property> bullet_properties;
+
+	int32_t _get_property_accessor(const String& property);
+
 	template<typename T>
 	void _swap(T &a, T &b) {
 		T t = a;
@@ -49,33 +142,102 @@ public:
 	int32_t get_available_bullets();
 	int32_t get_active_bullets();
 
+	// Instances written by the last update of a batched pool, for the active bullets only.
+	const PoolRealArray& get_instances_data() {
+		return instances_data;
+	}
+	int32_t get_instances_amount() {
+		return instances_amount;
+	}
+	// Lets `batch_group` draw the bullets of a batched pool, using the `atlas_rect` part of its atlas.
+	virtual void join_batch_group(BatchGroup* batch_group, Rect2 atlas_rect) = 0;
+
+	// Custom field of the kit named `name`, nullptr if the kit doesn't declare it.
+	CustomColumn* get_custom_column(const String& name);
+	// Position of the bullet in the pool storage, -1 if the ID is not valid.
+	virtual int32_t get_active_bullet_index(BulletID id) = 0;
+
 	virtual int32_t _process(float delta) = 0;
 
+	// Processing split in phases, used to spread the work of a frame on multiple threads.
+	// Only _process_chunk can run outside the main thread, and only if _is_thread_safe returns true.
+	virtual bool _is_thread_safe() = 0;
+	virtual int32_t _begin_process(float delta, int32_t chunk_size) = 0;
+	virtual void _process_chunk(int32_t chunk) = 0;
+	virtual int32_t _end_process() = 0;
+
+	// Adds `amount` available bullets, using the shapes starting at `first_shape_index` and the given cycles if any.
+	virtual void grow(int32_t first_shape_index, int32_t amount, const int32_t* cycles) = 0;
+	// Removes the bullets using the shapes starting at `first_shape_index`, if none of them is active.
+	// The cycles of the removed bullets are written to `cycles`, so that their IDs are never reused.
+	virtual bool shrink(int32_t first_shape_index, int32_t amount, int32_t* cycles) = 0;
+
 	virtual void spawn_bullet(Dictionary properties) = 0;
+	virtual int32_t spawn_bullets(PoolVector2Array positions, PoolVector2Array velocities,
+		PoolRealArray rotations, PoolRealArray lifetimes) = 0;
 	virtual BulletID obtain_bullet() = 0;
 	virtual bool release_bullet(BulletID id) = 0;
+	virtual int32_t release_all_bullets() = 0;
+	virtual int32_t release_bullets_in(const QueryRegion& region) = 0;
 	virtual bool is_bullet_valid(BulletID id) = 0;
 
 	virtual bool is_bullet_existing(int32_t shape_index) = 0;
 	virtual BulletID get_bullet_from_shape(int32_t shape_index) = 0;
 
+	virtual void _detect_collisions(const std::vector<CollisionTarget>& targets, std::vector<std::pair<BulletID, int64_t>>& hits) = 0;
+	virtual void query_bullets(const QueryRegion& region, std::vector<BulletID>& result) = 0;
+
 	virtual void set_bullet_property(BulletID id, String property, Variant value) = 0;
 	virtual Variant get_bullet_property(BulletID id, String property) = 0;
+
+	// Typed versions of the property accessors for the fields every bullet has. Setters return false for invalid IDs.
+	virtual bool set_bullet_transform(BulletID id, Transform2D value) = 0;
+	virtual Transform2D get_bullet_transform(BulletID id) = 0;
+	virtual bool set_bullet_velocity(BulletID id, Vector2 value) = 0;
+	virtual Vector2 get_bullet_velocity(BulletID id) = 0;
+	virtual bool set_bullet_lifetime(BulletID id, float value) = 0;
+	virtual float get_bullet_lifetime(BulletID id) = 0;
 };
 
-template <class Kit, class BulletType>
+// Derived is the kit pool type itself: hooks are called on it directly, so they are resolved at compile time.
+// Kit pools define their hooks as public members, shadowing the defaults below.
+template <class Derived, class Kit, class BulletType>
 class AbstractBulletsPool : public BulletsPool {
 
 protected:
 	Ref<Kit> kit;
-	BulletType** bullets = nullptr;
+	// Kit specific fields of the bullets, parallel to the shared storage.
+	std::vector<typename BulletType::Fields> fields;
+	// Script-facing view, created the first time a bullet has to be accessed by property name.
+	BulletType* view = nullptr;
+
+	inline void _init_bullet(int32_t index);
+	inline void _enable_bullet(int32_t index);
+	inline void _disable_bullet(int32_t index);
+	inline bool _process_bullet(int32_t index, float delta);
+	inline int32_t _process_bullets(float delta, int32_t begin, int32_t end, int32_t* to_release);
+	// Called on the main thread before the chunks of a frame are processed.
+	inline void _prepare_bullets(float delta);
+	inline void _bind_view(BulletType* view, int32_t index);
 
-	virtual inline void _init_bullet(BulletType* bullet);
-	virtual inline void _enable_bullet(BulletType* bullet);
-	virtual inline void _disable_bullet(BulletType* bullet);
-	virtual inline bool _process_bullet(BulletType* bullet, float delta);
+	inline Derived* _derived() { return static_cast<Derived*>(this); }
 
+	inline int32_t _get_bullet_index(int32_t shape_index);
+	// Records the draw command of a bullet with its own canvas item.
+	inline void _draw_bullet(int32_t index);
+	inline void _show_bullet(int32_t index);
+	inline void _hide_bullet(int32_t index);
 	inline void _release_bullet(int32_t index);
+	inline void _swap_bullets(int32_t a, int32_t b);
+	inline BulletType* _get_view(int32_t index);
+	inline void _upload_transform(int32_t index);
+	inline void _update_instances();
+	inline int32_t _integrate_bullets(float delta, int32_t begin, int32_t end, int32_t* to_release);
+	inline void _update_spatial_hash();
+	inline void _reset_bullet_state(int32_t index);
+	inline void _animate_bullets(int32_t begin, int32_t end);
+	inline void _set_property(int32_t index, const String& property, const Variant& value);
+	inline Variant _get_property(int32_t index, const String& property);
 
 public:
 	AbstractBulletsPool() {}
@@ -86,16 +248,40 @@ public:
 
 	virtual int32_t _process(float delta) override;
 
+	virtual bool _is_thread_safe() override;
+	virtual int32_t _begin_process(float delta, int32_t chunk_size) override;
+	virtual void _process_chunk(int32_t chunk) override;
+	virtual int32_t _end_process() override;
+
+	virtual void grow(int32_t first_shape_index, int32_t amount, const int32_t* cycles) override;
+	virtual bool shrink(int32_t first_shape_index, int32_t amount, int32_t* cycles) override;
+	virtual void join_batch_group(BatchGroup* batch_group, Rect2 atlas_rect) override;
+
 	virtual void spawn_bullet(Dictionary properties) override;
+	virtual int32_t spawn_bullets(PoolVector2Array positions, PoolVector2Array velocities,
+		PoolRealArray rotations, PoolRealArray lifetimes) override;
 	virtual BulletID obtain_bullet() override;
 	virtual bool release_bullet(BulletID id) override;
+	virtual int32_t release_all_bullets() override;
+	virtual int32_t release_bullets_in(const QueryRegion& region) override;
 	virtual bool is_bullet_valid(BulletID id) override;
+	virtual int32_t get_active_bullet_index(BulletID id) override;
 
 	virtual bool is_bullet_existing(int32_t shape_index) override;
 	virtual BulletID get_bullet_from_shape(int32_t shape_index) override;
 
+	virtual void _detect_collisions(const std::vector<CollisionTarget>& targets, std::vector<std::pair<BulletID, int64_t>>& hits) override;
+	virtual void query_bullets(const QueryRegion& region, std::vector<BulletID>& result) override;
+
 	virtual void set_bullet_property(BulletID id, String property, Variant value) override;
 	virtual Variant get_bullet_property(BulletID id, String property) override;
+
+	virtual bool set_bullet_transform(BulletID id, Transform2D value) override;
+	virtual Transform2D get_bullet_transform(BulletID id) override;
+	virtual bool set_bullet_velocity(BulletID id, Vector2 value) override;
+	virtual Vector2 get_bullet_velocity(BulletID id) override;
+	virtual bool set_bullet_lifetime(BulletID id, float value) override;
+	virtual float get_bullet_lifetime(BulletID id) override;
 };
 
 #include "bullets_pool.inl"
@@ -4,211 +4,668 @@
 #include <Viewport.hpp>
 #include <Font.hpp>
 
+#include <type_traits>
+
 #include "bullets_pool.h"
+#include "bullets_kernels.h"
 
 using namespace godot;
 
 
 //-- START Default "standard" implementations.
 
-template <class Kit, class BulletType>
-void AbstractBulletsPool<Kit, BulletType>::_init_bullet(BulletType* bullet) {}
-
-template <class Kit, class BulletType>
-void AbstractBulletsPool<Kit, BulletType>::_enable_bullet(BulletType* bullet) {
-	bullet->lifetime = 0.0f;
+template <class Derived, class Kit, class BulletType>
+void AbstractBulletsPool<Derived, Kit, BulletType>::_init_bullet(int32_t index) {}
 
-	Rect2 texture_rect = Rect2(-kit->texture->get_size() / 2.0f, kit->texture->get_size());
-	RID texture_rid = kit->texture->get_rid();
-	
-	VisualServer::get_singleton()->canvas_item_add_texture_rect(bullet->item_rid,
-		texture_rect,
-		texture_rid);
+template <class Derived, class Kit, class BulletType>
+void AbstractBulletsPool<Derived, Kit, BulletType>::_enable_bullet(int32_t index) {
+	bullets.lifetimes[index] = 0.0f;
 }
 
-template <class Kit, class BulletType>
-void AbstractBulletsPool<Kit, BulletType>::_disable_bullet(BulletType* bullet) {
-	VisualServer::get_singleton()->canvas_item_clear(bullet->item_rid);
-}
+template <class Derived, class Kit, class BulletType>
+void AbstractBulletsPool<Derived, Kit, BulletType>::_disable_bullet(int32_t index) {}
 
-template <class Kit, class BulletType>
-bool AbstractBulletsPool<Kit, BulletType>::_process_bullet(BulletType* bullet, float delta) {
-	bullet->transform.set_origin(bullet->transform.get_origin() + bullet->velocity * delta);
+template <class Derived, class Kit, class BulletType>
+bool AbstractBulletsPool<Derived, Kit, BulletType>::_process_bullet(int32_t index, float delta) {
+	bullets.origins[index] += bullets.velocities[index] * delta;
 
-	if(!active_rect.has_point(bullet->transform.get_origin())) {
+	if(!active_rect.has_point(bullets.origins[index])) {
 		return true;
 	}
 
-	bullet->lifetime += delta;
+	bullets.lifetimes[index] += delta;
 	return false;
 }
 
+template <class Derived, class Kit, class BulletType>
+int32_t AbstractBulletsPool<Derived, Kit, BulletType>::_process_bullets(float delta, int32_t begin, int32_t end, int32_t* to_release) {
+	// Kits keeping the default _process_bullet get the vectorized version of it.
+	if(std::is_same<decltype(&Derived::_process_bullet), bool (AbstractBulletsPool::*)(int32_t, float)>::value) {
+		return _integrate_bullets(delta, begin, end, to_release);
+	}
+	int32_t amount = 0;
+	for(int32_t i = begin; i < end; i++) {
+		Vector2 origin = bullets.origins[i];
+		if(_derived()->_process_bullet(i, delta)) {
+			to_release[amount++] = i;
+		}
+		if(bullets.origins[i] != origin) {
+			bullets.transforms_dirty[i] = 1;
+		}
+	}
+	return amount;
+}
+
+template <class Derived, class Kit, class BulletType>
+void AbstractBulletsPool<Derived, Kit, BulletType>::_prepare_bullets(float delta) {}
+
+template <class Derived, class Kit, class BulletType>
+void AbstractBulletsPool<Derived, Kit, BulletType>::_bind_view(BulletType* view, int32_t index) {
+	view->_bind(&bullets, index, &fields[index]);
+}
+
+template <class Derived, class Kit, class BulletType>
+bool AbstractBulletsPool<Derived, Kit, BulletType>::_is_thread_safe() {
+	// Kits defining their own processing may access Godot objects, they have to opt in by defining this method.
+	return std::is_same<decltype(&Derived::_process_bullet), bool (AbstractBulletsPool::*)(int32_t, float)>::value &&
+		std::is_same<decltype(&Derived::_process_bullets), int32_t (AbstractBulletsPool::*)(float, int32_t, int32_t, int32_t*)>::value;
+}
+
 //-- END Default "standard" implementation.
 
-template <class Kit, class BulletType>
-AbstractBulletsPool<Kit, BulletType>::~AbstractBulletsPool() {
+template <class Derived, class Kit, class BulletType>
+AbstractBulletsPool<Derived, Kit, BulletType>::~AbstractBulletsPool() {
 	// Bullets node is responsible for clearing all the area and area shapes
-	for(int32_t i = 0; i < pool_size; i++) {
-		VisualServer::get_singleton()->free_rid(bullets[i]->item_rid);
-		bullets[i]->free();
+	if(batched_rendering) {
+		// Pools in a batch group have already freed them when joining it.
+		if(multimesh.is_valid()) {
+			VisualServer::get_singleton()->free_rid(multimesh);
+			VisualServer::get_singleton()->free_rid(mesh);
+		}
+	} else {
+		for(int32_t i = 0; i < pool_size; i++) {
+			VisualServer::get_singleton()->free_rid(bullets.item_rids[i]);
+		}
 	}
 	VisualServer::get_singleton()->free_rid(canvas_item);
 
-	delete[] bullets;
-	delete[] shapes_to_indices;
+	if(view != nullptr) {
+		view->free();
+	}
 }
 
-template <class Kit, class BulletType>
-void AbstractBulletsPool<Kit, BulletType>::_init(CanvasItem* canvas_parent, RID shared_area, int32_t starting_shape_index,
+template <class Derived, class Kit, class BulletType>
+void AbstractBulletsPool<Derived, Kit, BulletType>::_init(CanvasItem* canvas_parent, RID shared_area, int32_t starting_shape_index,
 		int32_t set_index, Ref<BulletKit> kit, int32_t pool_size, int32_t z_index) {
 	
 	// Check if collisions are enabled and if layer or mask are != 0, 
 	// otherwise the bullets would not collide with anything anyways.
-	this->collisions_enabled = kit->collisions_enabled && kit->collision_shape.is_valid() &&
+	bool collisions_requested = kit->collisions_enabled && kit->collision_shape.is_valid() &&
 		((int64_t)kit->collision_layer + (int64_t)kit->collision_mask) != 0;
+	// Native collisions replace the shared area shapes.
+	if(collisions_requested && kit->collision_detection == 1) {
+		this->native_shape = NativeShape::from_shape(kit->collision_shape);
+		if(native_shape.type == NativeShape::NONE) {
+			ERR_PRINT("Native collisions only support CircleShape2D and RectangleShape2D, collisions are disabled!");
+		}
+		this->native_collisions = native_shape.type != NativeShape::NONE;
+		this->collisions_enabled = false;
+	} else {
+		this->native_collisions = false;
+		this->collisions_enabled = collisions_requested;
+	}
+	this->batched_rendering = kit->rendering_mode == 1;
 	this->canvas_parent = canvas_parent;
 	this->shared_area = shared_area;
 	this->starting_shape_index = starting_shape_index;
 	this->kit = kit;
-	this->pool_size = pool_size;
 	this->set_index = set_index;
+	// Cells twice as big as the bullets keep both the cells visited by a query and the bullets per cell low.
+	NativeShape bullet_shape = kit->collision_shape.is_valid() ? NativeShape::from_shape(kit->collision_shape) : NativeShape();
+	Vector2 bullet_size = bullet_shape.type != NativeShape::NONE ? bullet_shape.get_half_size() * 2.0f : this->kit->texture->get_size();
+	this->spatial_hash_cell_size = 2.0f * (bullet_size.x > bullet_size.y ? bullet_size.x : bullet_size.y);
+	this->spatial_hash_dirty = true;
+
+	this->animation_frames = kit->animation_frames > 1 ? kit->animation_frames : 1;
+	this->animation_h_frames = kit->animation_h_frames > 1 ? kit->animation_h_frames : 1;
+	this->animation_v_frames = kit->animation_v_frames > 1 ? kit->animation_v_frames : 1;
+	this->animation_fps = kit->animation_fps;
+	this->animation_loop = kit->animation_loop;
+	this->frame_size = this->kit->texture->get_size() / Vector2(animation_h_frames, animation_v_frames);
+
+	// Custom fields get their columns before any bullet is added.
+	bullets.custom_columns.clear();
+	property_accessors.clear();
+	bullet_properties = BulletType::_get_properties();
+	Array custom_fields_names = kit->custom_fields.keys();
+	for(int32_t i = 0; i < custom_fields_names.size(); i++) {
+		CustomColumn column;
+		if(column.declare(custom_fields_names[i], kit->custom_fields[custom_fields_names[i]])) {
+			bullets.custom_columns.push_back(column);
+		} else {
+			ERR_PRINT("Custom fields can only be floats, ints, bools, Vector2s or Colors, the field is ignored!");
+		}
+	}
 
-	available_bullets = pool_size;
+	// Bullets are added by grow, starting from an empty pool.
+	this->pool_size = 0;
+	available_bullets = 0;
 	active_bullets = 0;
 
-	bullets = new BulletType*[pool_size];
-	shapes_to_indices = new int32_t[pool_size];
-
 	canvas_item = VisualServer::get_singleton()->canvas_item_create();
 	VisualServer::get_singleton()->canvas_item_set_parent(canvas_item, canvas_parent->get_canvas_item());
 	VisualServer::get_singleton()->canvas_item_set_z_index(canvas_item, z_index);
 
-	for(int32_t i = 0; i < pool_size; i++) {
-		BulletType* bullet = BulletType::_new();
-		bullets[i] = bullet;
+	if(batched_rendering) {
+		Vector2 half_size = frame_size / 2.0f;
+
+		// A quad the size of a frame of the kit texture, instanced once for each active bullet.
+		// Animated kits select the frame through the instance custom data.
+		PoolVector2Array vertices = PoolVector2Array();
+		vertices.append(Vector2(-half_size.x, -half_size.y));
+		vertices.append(Vector2(half_size.x, -half_size.y));
+		vertices.append(Vector2(half_size.x, half_size.y));
+		vertices.append(Vector2(-half_size.x, half_size.y));
+		PoolVector2Array uvs = PoolVector2Array();
+		uvs.append(Vector2(0.0f, 0.0f));
+		uvs.append(Vector2(1.0f, 0.0f));
+		uvs.append(Vector2(1.0f, 1.0f));
+		uvs.append(Vector2(0.0f, 1.0f));
+		PoolIntArray indices = PoolIntArray();
+		indices.append(0);
+		indices.append(1);
+		indices.append(2);
+		indices.append(0);
+		indices.append(2);
+		indices.append(3);
+
+		Array arrays = Array();
+		arrays.resize(VisualServer::ARRAY_MAX);
+		arrays[VisualServer::ARRAY_VERTEX] = vertices;
+		arrays[VisualServer::ARRAY_TEX_UV] = uvs;
+		arrays[VisualServer::ARRAY_INDEX] = indices;
+
+		mesh = VisualServer::get_singleton()->mesh_create();
+		VisualServer::get_singleton()->mesh_add_surface_from_arrays(mesh, VisualServer::PRIMITIVE_TRIANGLES, arrays);
+
+		multimesh = VisualServer::get_singleton()->multimesh_create();
+		VisualServer::get_singleton()->multimesh_set_mesh(multimesh, mesh);
+
+		VisualServer::get_singleton()->canvas_item_set_material(canvas_item, kit->material->get_rid());
+		VisualServer::get_singleton()->canvas_item_add_multimesh(canvas_item, multimesh, this->kit->texture->get_rid());
+	}
+
+	grow(starting_shape_index, pool_size, nullptr);
+}
+
+template <class Derived, class Kit, class BulletType>
+void AbstractBulletsPool<Derived, Kit, BulletType>::grow(int32_t first_shape_index, int32_t amount, const int32_t* cycles) {
+	int32_t begin = pool_size;
+	int32_t previous_available_bullets = available_bullets;
+	pool_size += amount;
+	available_bullets += amount;
+
+	bullets.resize(pool_size);
+	fields.resize(pool_size);
+	bullets_to_release.resize(pool_size);
+	int32_t shapes_end = first_shape_index + amount - starting_shape_index;
+	if((int32_t)shapes_to_indices.size() < shapes_end) {
+		shapes_to_indices.resize(shapes_end, -1);
+		modulates.resize(shapes_end);
+	}
+
+	for(int32_t i = begin; i < pool_size; i++) {
+		int32_t shape_index = first_shape_index + i - begin;
 
-		bullet->item_rid = VisualServer::get_singleton()->canvas_item_create();
-		VisualServer::get_singleton()->canvas_item_set_parent(bullet->item_rid, canvas_item);
-		VisualServer::get_singleton()->canvas_item_set_material(bullet->item_rid, kit->material->get_rid());
+		if(!batched_rendering) {
+			RID item_rid = VisualServer::get_singleton()->canvas_item_create();
+			bullets.item_rids[i] = item_rid;
+
+			VisualServer::get_singleton()->canvas_item_set_parent(item_rid, canvas_item);
+			VisualServer::get_singleton()->canvas_item_set_material(item_rid, kit->material->get_rid());
+			// The draw command is recorded once, spawning and releasing the bullet only toggle its visibility.
+			VisualServer::get_singleton()->canvas_item_set_visible(item_rid, false);
+			_draw_bullet(i);
+		}
+
+		// The shape index identifies the bullet even when collisions are disabled.
+		bullets.shape_indices[i] = shape_index;
+		shapes_to_indices[shape_index - starting_shape_index] = i;
+		if(cycles != nullptr) {
+			bullets.cycles[i] = cycles[i - begin];
+		}
 
 		if(collisions_enabled) {
 			RID shared_shape_rid = kit->collision_shape->get_rid();
 
 			Physics2DServer::get_singleton()->area_add_shape(shared_area, shared_shape_rid, Transform2D(), true);
-			bullet->shape_index = starting_shape_index + i;
-			shapes_to_indices[i] = i;
 		}
 
 		Color color = Color(1.0f, 1.0f, 1.0f, 1.0f);
 		switch(kit->unique_modulate_component) {
 			case 1: // Red
-				color.r = fmod((starting_shape_index + i) * 0.7213f, 1.0f);
+				color.r = fmod(shape_index * 0.7213f, 1.0f);
 				break;
 			case 2: // Green
-				color.g = fmod((starting_shape_index + i) * 0.7213f, 1.0f);
+				color.g = fmod(shape_index * 0.7213f, 1.0f);
 				break;
 			case 3: // Blue
-				color.b = fmod((starting_shape_index + i) * 0.7213f, 1.0f);
+				color.b = fmod(shape_index * 0.7213f, 1.0f);
 				break;
 			case 4: // Alpha
-				color.a = fmod((starting_shape_index + i) * 0.7213f, 1.0f);
+				color.a = fmod(shape_index * 0.7213f, 1.0f);
 				break;
 			default: // None or other values
 				break;
 		}
-		VisualServer::get_singleton()->canvas_item_set_modulate(bullet->item_rid, color);
+		modulates[shape_index - starting_shape_index] = color;
+		if(!batched_rendering) {
+			VisualServer::get_singleton()->canvas_item_set_modulate(bullets.item_rids[i], color);
+		}
+
+		_derived()->_init_bullet(i);
+	}
 
-		_init_bullet(bullet);
+	// The new bullets are available, swap them with the first active ones to keep the active bullets at the end.
+	// Active bullets keep their shape, so their IDs stay valid.
+	int32_t moved = active_bullets < amount ? active_bullets : amount;
+	for(int32_t i = 0; i < moved; i++) {
+		_swap_bullets(previous_available_bullets + i, pool_size - 1 - i);
+	}
+	spatial_hash_dirty = true;
+
+	if(batched_rendering) {
+		if(batch_group == nullptr) {
+			VisualServer::get_singleton()->multimesh_allocate(multimesh, pool_size, VisualServer::MULTIMESH_TRANSFORM_2D,
+				VisualServer::MULTIMESH_COLOR_FLOAT, animation_frames > 1 ?
+					VisualServer::MULTIMESH_CUSTOM_DATA_FLOAT : VisualServer::MULTIMESH_CUSTOM_DATA_NONE);
+		}
+		instances_data.resize(pool_size * _get_instance_floats());
+		_update_instances();
 	}
 }
 
-template <class Kit, class BulletType>
-int32_t AbstractBulletsPool<Kit, BulletType>::_process(float delta) {
+template <class Derived, class Kit, class BulletType>
+bool AbstractBulletsPool<Derived, Kit, BulletType>::shrink(int32_t first_shape_index, int32_t amount, int32_t* cycles) {
+	for(int32_t i = 0; i < amount; i++) {
+		int32_t bullet_index = _get_bullet_index(first_shape_index + i);
+		if(bullet_index < 0 || bullet_index >= available_bullets) {
+			return false;
+		}
+	}
+	// Move the bullets to remove at the start of the pool, then drop them.
+	for(int32_t i = 0; i < amount; i++) {
+		int32_t bullet_index = _get_bullet_index(first_shape_index + i);
+		_swap_bullets(bullet_index, i);
+
+		// The current cycle was never handed out, the next bullet using this shape can start from it.
+		cycles[i] = bullets.cycles[i];
+		if(!batched_rendering) {
+			VisualServer::get_singleton()->free_rid(bullets.item_rids[i]);
+		}
+	}
+	if(collisions_enabled) {
+		// These are the last shapes of the shared area, removing them doesn't change the index of the others.
+		for(int32_t i = amount - 1; i >= 0; i--) {
+			Physics2DServer::get_singleton()->area_remove_shape(shared_area, first_shape_index + i);
+		}
+	}
+	bullets.erase_front(amount);
+	fields.erase(fields.begin(), fields.begin() + amount);
+	pool_size -= amount;
+	available_bullets -= amount;
+	bullets_to_release.resize(pool_size);
+
+	for(int32_t i = 0; i < amount; i++) {
+		shapes_to_indices[first_shape_index + i - starting_shape_index] = -1;
+	}
+	for(int32_t i = 0; i < (int32_t)shapes_to_indices.size(); i++) {
+		if(shapes_to_indices[i] >= 0) {
+			shapes_to_indices[i] -= amount;
+		}
+	}
+	while(!shapes_to_indices.empty() && shapes_to_indices.back() < 0) {
+		shapes_to_indices.pop_back();
+	}
+	modulates.resize(shapes_to_indices.size());
+	spatial_hash_dirty = true;
+
+	if(batched_rendering) {
+		if(batch_group == nullptr) {
+			VisualServer::get_singleton()->multimesh_allocate(multimesh, pool_size, VisualServer::MULTIMESH_TRANSFORM_2D,
+				VisualServer::MULTIMESH_COLOR_FLOAT, animation_frames > 1 ?
+					VisualServer::MULTIMESH_CUSTOM_DATA_FLOAT : VisualServer::MULTIMESH_CUSTOM_DATA_NONE);
+		}
+		instances_data.resize(pool_size * _get_instance_floats());
+		_update_instances();
+	}
+	return true;
+}
+
+template <class Derived, class Kit, class BulletType>
+void AbstractBulletsPool<Derived, Kit, BulletType>::join_batch_group(BatchGroup* batch_group, Rect2 atlas_rect) {
+	if(!batched_rendering) {
+		return;
+	}
+	// The group draws the bullets from now on, the pool only writes their instances.
+	VisualServer::get_singleton()->canvas_item_clear(canvas_item);
+	VisualServer::get_singleton()->free_rid(multimesh);
+	VisualServer::get_singleton()->free_rid(mesh);
+	multimesh = RID();
+	mesh = RID();
+
+	this->batch_group = batch_group;
+	this->atlas_rect = atlas_rect;
+	batch_group->pools.push_back(this);
+	instances_data.resize(pool_size * _get_instance_floats());
+	_update_instances();
+}
+
+template <class Derived, class Kit, class BulletType>
+int32_t AbstractBulletsPool<Derived, Kit, BulletType>::_process(float delta) {
+	// Processing the whole pool as a single chunk.
+	int32_t chunks_amount = _begin_process(delta, pool_size);
+	for(int32_t i = 0; i < chunks_amount; i++) {
+		_process_chunk(i);
+	}
+	return _end_process();
+}
+
+template <class Derived, class Kit, class BulletType>
+int32_t AbstractBulletsPool<Derived, Kit, BulletType>::_begin_process(float delta, int32_t chunk_size) {
 	if(kit->use_viewport_as_active_rect) {
 		active_rect = canvas_parent->get_viewport()->get_visible_rect();
 	} else {
 		active_rect = kit->active_rect;
 	}
+	this->process_delta = delta;
+	this->chunk_size = chunk_size > 0 ? chunk_size : 1;
+	this->chunks_begin = available_bullets;
+	_derived()->_prepare_bullets(delta);
+
+	int32_t chunks_amount = (active_bullets + this->chunk_size - 1) / this->chunk_size;
+	chunks_released.resize(chunks_amount);
+	return chunks_amount;
+}
+
+template <class Derived, class Kit, class BulletType>
+void AbstractBulletsPool<Derived, Kit, BulletType>::_process_chunk(int32_t chunk) {
+	int32_t begin = chunks_begin + chunk * chunk_size;
+	int32_t end = begin + chunk_size < pool_size ? begin + chunk_size : pool_size;
+
+	chunks_released[chunk] = _derived()->_process_bullets(process_delta, begin, end, &bullets_to_release[begin]);
+	if(animation_frames > 1) {
+		_animate_bullets(begin, end);
+	}
+}
+
+template <class Derived, class Kit, class BulletType>
+int32_t AbstractBulletsPool<Derived, Kit, BulletType>::_end_process() {
 	int32_t amount_variation = 0;
 
-	if(collisions_enabled) {
-		for(int32_t i = pool_size - 1; i >= available_bullets; i--) {
-			BulletType* bullet = bullets[i];
-
-			if(_process_bullet(bullet, delta)) {
-				_release_bullet(i);
-				amount_variation -= 1;
-				i += 1;
-				continue;
-			}
-			
-			VisualServer::get_singleton()->canvas_item_set_transform(bullet->item_rid, bullet->transform);
-			Physics2DServer::get_singleton()->area_set_shape_transform(shared_area, bullet->shape_index, bullet->transform);
+	// Chunks are merged in order, so the result doesn't depend on how many threads processed them.
+	// Releasing in ascending order is safe: a release only swaps the bullet with the first active one,
+	// which has a lower index than every bullet still to release.
+	for(int32_t i = 0; i < (int32_t)chunks_released.size(); i++) {
+		int32_t* to_release = &bullets_to_release[chunks_begin + i * chunk_size];
+
+		for(int32_t j = 0; j < chunks_released[i]; j++) {
+			_release_bullet(to_release[j]);
 		}
-	} else {
-		for(int32_t i = pool_size - 1; i >= available_bullets; i--) {
-			BulletType* bullet = bullets[i];
-
-			if(_process_bullet(bullet, delta)) {
-				_release_bullet(i);
-				amount_variation -= 1;
-				i += 1;
-				continue;
+		amount_variation -= chunks_released[i];
+	}
+
+	// Only bullets that moved need to be sent to the servers.
+	for(int32_t i = available_bullets; i < pool_size; i++) {
+		if(bullets.transforms_dirty[i]) {
+			_upload_transform(i);
+		}
+	}
+	if(batched_rendering) {
+		_update_instances();
+	} else if(animation_frames > 1) {
+		// Bullets with their own canvas item draw a new command only when their frame changes.
+		for(int32_t i = available_bullets; i < pool_size; i++) {
+			if(bullets.frames[i] != bullets.drawn_frames[i]) {
+				_draw_bullet(i);
 			}
-			
-			VisualServer::get_singleton()->canvas_item_set_transform(bullet->item_rid, bullet->transform);
 		}
 	}
+	spatial_hash_dirty = true;
+	if(native_collisions) {
+		_update_spatial_hash();
+	}
 	return amount_variation;
 }
 
-template <class Kit, class BulletType>
-void AbstractBulletsPool<Kit, BulletType>::spawn_bullet(Dictionary properties) {
+template <class Derived, class Kit, class BulletType>
+void AbstractBulletsPool<Derived, Kit, BulletType>::_update_instances() {
+	// Write the instances in the same order active bullets are stored, in the layout expected by the VisualServer.
+	{
+		// The write access must be released before the array is sent to the VisualServer.
+		PoolRealArray::Write write = instances_data.write();
+		float* data = write.ptr();
+		int32_t instance_floats = _get_instance_floats();
+		// The quad of a batch group is a unit one, scaled here to the frame size.
+		Vector2 quad_size = batch_group != nullptr ? frame_size : Vector2(1.0f, 1.0f);
+		bool has_texture_rect = instance_floats == BatchGroup::instance_floats;
+
+		for(int32_t i = available_bullets; i < pool_size; i++) {
+			const Vector2 x_axis = bullets.x_axes[i] * quad_size.x;
+			const Vector2 y_axis = bullets.y_axes[i] * quad_size.y;
+			const Vector2& origin = bullets.origins[i];
+			const Color& color = modulates[bullets.shape_indices[i] - starting_shape_index];
+
+			data[0] = x_axis.x;
+			data[1] = y_axis.x;
+			data[2] = 0.0f;
+			data[3] = origin.x;
+			data[4] = x_axis.y;
+			data[5] = y_axis.y;
+			data[6] = 0.0f;
+			data[7] = origin.y;
+			data[8] = color.r;
+			data[9] = color.g;
+			data[10] = color.b;
+			data[11] = color.a;
+			if(has_texture_rect) {
+				Rect2 texture_rect = animation_frames > 1 ? _get_frame_rect(bullets.frames[i]) : Rect2(0.0f, 0.0f, 1.0f, 1.0f);
+				if(batch_group != nullptr) {
+					texture_rect.position = atlas_rect.position + texture_rect.position * atlas_rect.size;
+					texture_rect.size *= atlas_rect.size;
+				}
+				data[12] = texture_rect.position.x;
+				data[13] = texture_rect.position.y;
+				data[14] = texture_rect.size.x;
+				data[15] = texture_rect.size.y;
+			}
+			data += instance_floats;
+		}
+	}
+
+	instances_amount = active_bullets;
+	if(batch_group != nullptr) {
+		// Sent by Bullets together with the other pools of the group.
+		batch_group->dirty = true;
+		return;
+	}
+	VisualServer::get_singleton()->multimesh_set_as_bulk_array(multimesh, instances_data);
+	VisualServer::get_singleton()->multimesh_set_visible_instances(multimesh, active_bullets);
+}
+
+template <class Derived, class Kit, class BulletType>
+int32_t AbstractBulletsPool<Derived, Kit, BulletType>::_integrate_bullets(float delta, int32_t begin, int32_t end, int32_t* to_release) {
+	if(begin >= end) {
+		return 0;
+	}
+	int32_t amount = integrate_bullets(&bullets.origins[begin], &bullets.velocities[begin],
+		&bullets.lifetimes[begin], end - begin, delta, active_rect, begin, to_release);
+
+	for(int32_t i = begin; i < end; i++) {
+		bullets.transforms_dirty[i] |= bullets.velocities[i] != Vector2();
+	}
+	return amount;
+}
+
+template <class Derived, class Kit, class BulletType>
+void AbstractBulletsPool<Derived, Kit, BulletType>::_upload_transform(int32_t index) {
+	Transform2D transform = bullets.get_transform(index);
+	if(!batched_rendering)
+		VisualServer::get_singleton()->canvas_item_set_transform(bullets.item_rids[index], transform);
+	if(collisions_enabled)
+		Physics2DServer::get_singleton()->area_set_shape_transform(shared_area, bullets.shape_indices[index], transform);
+	bullets.transforms_dirty[index] = 0;
+}
+
+template <class Derived, class Kit, class BulletType>
+void AbstractBulletsPool<Derived, Kit, BulletType>::_update_spatial_hash() {
+	spatial_hash.clear(spatial_hash_cell_size);
+
+	for(int32_t i = available_bullets; i < pool_size; i++) {
+		spatial_hash.insert(bullets.origins[i], i);
+	}
+	spatial_hash.build();
+	spatial_hash_dirty = false;
+}
+
+template <class Derived, class Kit, class BulletType>
+void AbstractBulletsPool<Derived, Kit, BulletType>::_detect_collisions(const std::vector<CollisionTarget>& targets,
+		std::vector<std::pair<BulletID, int64_t>>& hits) {
+	if(!native_collisions || active_bullets == 0) {
+		return;
+	}
+	if(spatial_hash_dirty) {
+		_update_spatial_hash();
+	}
+	Vector2 half_size = native_shape.get_half_size();
+
+	for(int32_t i = 0; i < (int32_t)targets.size(); i++) {
+		const CollisionTarget& target = targets[i];
+		if((target.collision_mask & kit->collision_layer) == 0) {
+			continue;
+		}
+		// Only bullets whose origin is within this rect can overlap the target.
+		Vector2 reach = target.shape.get_half_size() + half_size;
+
+		spatial_hash.query(Rect2(target.position - reach, reach * 2.0f), [&](int32_t index) {
+			if(native_shape.overlaps(bullets.origins[index], target.shape, target.position)) {
+				hits.push_back(std::make_pair(BulletID(bullets.shape_indices[index], bullets.cycles[index], set_index),
+					target.instance_id));
+			}
+		});
+	}
+}
+
+template <class Derived, class Kit, class BulletType>
+void AbstractBulletsPool<Derived, Kit, BulletType>::query_bullets(const QueryRegion& region, std::vector<BulletID>& result) {
+	if(active_bullets == 0) {
+		return;
+	}
+	if(spatial_hash_dirty) {
+		_update_spatial_hash();
+	}
+	spatial_hash.query(region.get_bounds(), [&](int32_t index) {
+		if(region.has_point(bullets.origins[index])) {
+			result.push_back(BulletID(bullets.shape_indices[index], bullets.cycles[index], set_index));
+		}
+	});
+}
+
+template <class Derived, class Kit, class BulletType>
+void AbstractBulletsPool<Derived, Kit, BulletType>::spawn_bullet(Dictionary properties) {
 	if(available_bullets > 0) {
 		available_bullets -= 1;
 		active_bullets += 1;
+		spatial_hash_dirty = true;
 
-		BulletType* bullet = bullets[available_bullets];
+		int32_t index = available_bullets;
 
 		if(collisions_enabled)
-			Physics2DServer::get_singleton()->area_set_shape_disabled(shared_area, bullet->shape_index, false);
+			Physics2DServer::get_singleton()->area_set_shape_disabled(shared_area, bullets.shape_indices[index], false);
 
+		_reset_bullet_state(index);
 		Array keys = properties.keys();
 		for(int32_t i = 0; i < keys.size(); i++) {
-			bullet->set(keys[i], properties[keys[i]]);
+			_set_property(index, keys[i], properties[keys[i]]);
 		}
 
-		VisualServer::get_singleton()->canvas_item_set_transform(bullet->item_rid, bullet->transform);
+		_upload_transform(index);
+
+		_show_bullet(index);
+		_derived()->_enable_bullet(index);
+	}
+}
+
+template <class Derived, class Kit, class BulletType>
+int32_t AbstractBulletsPool<Derived, Kit, BulletType>::spawn_bullets(PoolVector2Array positions, PoolVector2Array velocities,
+		PoolRealArray rotations, PoolRealArray lifetimes) {
+	int32_t amount = positions.size() < available_bullets ? positions.size() : available_bullets;
+	// Empty arrays mean the values were not provided.
+	bool has_velocities = velocities.size() > 0;
+	bool has_rotations = rotations.size() > 0;
+	bool has_lifetimes = lifetimes.size() > 0;
+
+	PoolVector2Array::Read positions_read = positions.read();
+	PoolVector2Array::Read velocities_read = velocities.read();
+	PoolRealArray::Read rotations_read = rotations.read();
+	PoolRealArray::Read lifetimes_read = lifetimes.read();
+
+	for(int32_t i = 0; i < amount; i++) {
+		available_bullets -= 1;
+		active_bullets += 1;
+		spatial_hash_dirty = true;
+
+		int32_t index = available_bullets;
+
 		if(collisions_enabled)
-			Physics2DServer::get_singleton()->area_set_shape_transform(shared_area, bullet->shape_index, bullet->transform);
+			Physics2DServer::get_singleton()->area_set_shape_disabled(shared_area, bullets.shape_indices[index], false);
+
+		_reset_bullet_state(index);
+		// Typed setters of the view, so that kits can still react to the values being set.
+		BulletType* bullet = _get_view(index);
+		bullet->set_transform(Transform2D(has_rotations ? rotations_read[i] : 0.0f, positions_read[i]));
+		bullet->set_velocity(has_velocities ? velocities_read[i] : Vector2());
 
-		_enable_bullet(bullet);
+		_upload_transform(index);
+
+		_show_bullet(index);
+		_derived()->_enable_bullet(index);
+
+		// Set after enabling the bullet, which resets it.
+		if(has_lifetimes)
+			bullets.lifetimes[index] = lifetimes_read[i];
 	}
+	return amount;
 }
 
-template <class Kit, class BulletType>
-BulletID AbstractBulletsPool<Kit, BulletType>::obtain_bullet() {
+template <class Derived, class Kit, class BulletType>
+BulletID AbstractBulletsPool<Derived, Kit, BulletType>::obtain_bullet() {
 	if(available_bullets > 0) {
 		available_bullets -= 1;
 		active_bullets += 1;
+		spatial_hash_dirty = true;
 
-		BulletType* bullet = bullets[available_bullets];
+		int32_t index = available_bullets;
 
 		if(collisions_enabled)
-			Physics2DServer::get_singleton()->area_set_shape_disabled(shared_area, bullet->shape_index, false);
+			Physics2DServer::get_singleton()->area_set_shape_disabled(shared_area, bullets.shape_indices[index], false);
 
-		_enable_bullet(bullet);
+		_reset_bullet_state(index);
+		// Sent at the end of the frame, unless the transform is set before.
+		bullets.transforms_dirty[index] = 1;
+		_show_bullet(index);
+		_derived()->_enable_bullet(index);
 
-		return BulletID(bullet->shape_index, bullet->cycle, set_index);
+		return BulletID(bullets.shape_indices[index], bullets.cycles[index], set_index);
 	}
 	return BulletID(-1, -1, -1);
 }
 
-template <class Kit, class BulletType>
-bool AbstractBulletsPool<Kit, BulletType>::release_bullet(BulletID id) {
-	if(id.index >= starting_shape_index && id.index < starting_shape_index + pool_size && id.set == set_index) {
-		int32_t bullet_index = shapes_to_indices[id.index - starting_shape_index];
-		if(bullet_index >= available_bullets && bullet_index < pool_size && id.cycle == bullets[bullet_index]->cycle) {
+template <class Derived, class Kit, class BulletType>
+bool AbstractBulletsPool<Derived, Kit, BulletType>::release_bullet(BulletID id) {
+	if(id.set == set_index) {
+		int32_t bullet_index = _get_bullet_index(id.index);
+		if(bullet_index >= 0 && bullet_index >= available_bullets && id.cycle == bullets.cycles[bullet_index]) {
 			_release_bullet(bullet_index);
 			return true;
 		}
@@ -216,78 +673,328 @@ bool AbstractBulletsPool<Kit, BulletType>::release_bullet(BulletID id) {
 	return false;
 }
 
-template <class Kit, class BulletType>
-void AbstractBulletsPool<Kit, BulletType>::_release_bullet(int32_t index) {
-	BulletType* bullet = bullets[index];
-	
+template <class Derived, class Kit, class BulletType>
+int32_t AbstractBulletsPool<Derived, Kit, BulletType>::release_all_bullets() {
+	int32_t released = active_bullets;
+
+	// Every bullet becomes available, so they can stay where they are.
+	for(int32_t i = available_bullets; i < pool_size; i++) {
+		if(collisions_enabled)
+			Physics2DServer::get_singleton()->area_set_shape_disabled(shared_area, bullets.shape_indices[i], true);
+
+		_derived()->_disable_bullet(i);
+		_hide_bullet(i);
+		bullets.cycles[i] += 1;
+	}
+	available_bullets = pool_size;
+	active_bullets = 0;
+	spatial_hash_dirty = true;
+
+	if(batched_rendering) {
+		_update_instances();
+	}
+	return released;
+}
+
+template <class Derived, class Kit, class BulletType>
+int32_t AbstractBulletsPool<Derived, Kit, BulletType>::release_bullets_in(const QueryRegion& region) {
+	if(active_bullets == 0) {
+		return 0;
+	}
+	if(spatial_hash_dirty) {
+		_update_spatial_hash();
+	}
+	region_candidates.clear();
+	spatial_hash.query(region.get_bounds(), [&](int32_t index) {
+		if(region.has_point(bullets.origins[index])) {
+			region_candidates.push_back(index);
+		}
+	});
+	// Releasing in ascending order compacts the pool in a single pass:
+	// each release only moves a bullet that is not in the region into the slot it frees.
+	std::sort(region_candidates.begin(), region_candidates.end());
+	for(int32_t i = 0; i < (int32_t)region_candidates.size(); i++) {
+		_release_bullet(region_candidates[i]);
+	}
+	int32_t released = (int32_t)region_candidates.size();
+	if(batched_rendering && released > 0) {
+		_update_instances();
+	}
+	return released;
+}
+
+template <class Derived, class Kit, class BulletType>
+void AbstractBulletsPool<Derived, Kit, BulletType>::_release_bullet(int32_t index) {
 	if(collisions_enabled)
-		Physics2DServer::get_singleton()->area_set_shape_disabled(shared_area, bullet->shape_index, true);
+		Physics2DServer::get_singleton()->area_set_shape_disabled(shared_area, bullets.shape_indices[index], true);
 	
-	_disable_bullet(bullet);
-	bullet->cycle += 1;
+	_derived()->_disable_bullet(index);
+	_hide_bullet(index);
+	bullets.cycles[index] += 1;
 
-	_swap(shapes_to_indices[bullet->shape_index - starting_shape_index], shapes_to_indices[bullets[available_bullets]->shape_index - starting_shape_index]);
-	_swap(bullets[index], bullets[available_bullets]);
+	_swap_bullets(index, available_bullets);
 
 	available_bullets += 1;
 	active_bullets -= 1;
+	spatial_hash_dirty = true;
 }
 
-template <class Kit, class BulletType>
-bool AbstractBulletsPool<Kit, BulletType>::is_bullet_valid(BulletID id) {
-	if(id.index >= starting_shape_index && id.index < starting_shape_index + pool_size && id.set == set_index) {
-		int32_t bullet_index = shapes_to_indices[id.index - starting_shape_index];
-		if(bullet_index >= available_bullets && bullet_index < pool_size && id.cycle == bullets[bullet_index]->cycle) {
-			return true;
+template <class Derived, class Kit, class BulletType>
+void AbstractBulletsPool<Derived, Kit, BulletType>::_reset_bullet_state(int32_t index) {
+	bullets.reset_custom_fields(index);
+
+	if(animation_frames > 1) {
+		float phase = 0.0f;
+		if(kit->animation_random_phase && animation_fps > 0.0f) {
+			// Same pseudo-random spread as the unique modulate, over the duration of the animation.
+			phase = fmod(bullets.shape_indices[index] * 0.7213f, 1.0f) * animation_frames / animation_fps;
 		}
+		bullets.animation_phases[index] = phase;
+		bullets.frames[index] = _get_animation_frame(phase);
 	}
-	return false;
 }
 
-template <class Kit, class BulletType>
-bool AbstractBulletsPool<Kit, BulletType>::is_bullet_existing(int32_t shape_index) {
-	if(shape_index >= starting_shape_index && shape_index < starting_shape_index + pool_size) {
-		int32_t bullet_index = shapes_to_indices[shape_index - starting_shape_index];
-		if(bullet_index >= available_bullets) {
+template <class Derived, class Kit, class BulletType>
+void AbstractBulletsPool<Derived, Kit, BulletType>::_animate_bullets(int32_t begin, int32_t end) {
+	for(int32_t i = begin; i < end; i++) {
+		bullets.frames[i] = _get_animation_frame(bullets.lifetimes[i] + bullets.animation_phases[i]);
+	}
+}
+
+template <class Derived, class Kit, class BulletType>
+void AbstractBulletsPool<Derived, Kit, BulletType>::_draw_bullet(int32_t index) {
+	RID item_rid = bullets.item_rids[index];
+	RID texture_rid = kit->texture->get_rid();
+
+	VisualServer::get_singleton()->canvas_item_clear(item_rid);
+	if(animation_frames > 1) {
+		Rect2 frame_rect = _get_frame_rect(bullets.frames[index]);
+
+		VisualServer::get_singleton()->canvas_item_add_texture_rect_region(item_rid,
+			Rect2(-frame_size / 2.0f, frame_size),
+			texture_rid,
+			Rect2(frame_rect.position * kit->texture->get_size(), frame_size));
+		bullets.drawn_frames[index] = bullets.frames[index];
+		return;
+	}
+	Rect2 texture_rect = Rect2(-kit->texture->get_size() / 2.0f, kit->texture->get_size());
+
+	VisualServer::get_singleton()->canvas_item_add_texture_rect(item_rid,
+		texture_rect,
+		texture_rid);
+}
+
+template <class Derived, class Kit, class BulletType>
+void AbstractBulletsPool<Derived, Kit, BulletType>::_show_bullet(int32_t index) {
+	// Batched pools draw active bullets by instance count alone.
+	if(!batched_rendering) {
+		// Animated bullets may start from another frame than the one they were last drawn with.
+		if(animation_frames > 1 && bullets.frames[index] != bullets.drawn_frames[index]) {
+			_draw_bullet(index);
+		}
+		VisualServer::get_singleton()->canvas_item_set_visible(bullets.item_rids[index], true);
+	}
+}
+
+template <class Derived, class Kit, class BulletType>
+void AbstractBulletsPool<Derived, Kit, BulletType>::_hide_bullet(int32_t index) {
+	if(!batched_rendering) {
+		VisualServer::get_singleton()->canvas_item_set_visible(bullets.item_rids[index], false);
+	}
+}
+
+template <class Derived, class Kit, class BulletType>
+int32_t AbstractBulletsPool<Derived, Kit, BulletType>::_get_bullet_index(int32_t shape_index) {
+	int32_t offset = shape_index - starting_shape_index;
+	if(offset < 0 || offset >= (int32_t)shapes_to_indices.size()) {
+		return -1;
+	}
+	return shapes_to_indices[offset];
+}
+
+template <class Derived, class Kit, class BulletType>
+void AbstractBulletsPool<Derived, Kit, BulletType>::_swap_bullets(int32_t a, int32_t b) {
+	_swap(shapes_to_indices[bullets.shape_indices[a] - starting_shape_index], shapes_to_indices[bullets.shape_indices[b] - starting_shape_index]);
+	bullets.swap(a, b);
+	_swap(fields[a], fields[b]);
+}
+
+template <class Derived, class Kit, class BulletType>
+BulletType* AbstractBulletsPool<Derived, Kit, BulletType>::_get_view(int32_t index) {
+	if(view == nullptr) {
+		view = BulletType::_new();
+	}
+	_derived()->_bind_view(view, index);
+	return view;
+}
+
+template <class Derived, class Kit, class BulletType>
+bool AbstractBulletsPool<Derived, Kit, BulletType>::is_bullet_valid(BulletID id) {
+	if(id.set == set_index) {
+		int32_t bullet_index = _get_bullet_index(id.index);
+		if(bullet_index >= 0 && bullet_index >= available_bullets && id.cycle == bullets.cycles[bullet_index]) {
 			return true;
 		}
 	}
 	return false;
 }
 
-template <class Kit, class BulletType>
-BulletID AbstractBulletsPool<Kit, BulletType>::get_bullet_from_shape(int32_t shape_index) {
-	if(shape_index >= starting_shape_index && shape_index < starting_shape_index + pool_size) {
-		int32_t bullet_index = shapes_to_indices[shape_index - starting_shape_index];
-		if(bullet_index >= available_bullets) {
-			return BulletID(shape_index, bullets[bullet_index]->cycle, set_index);
-		}
+template <class Derived, class Kit, class BulletType>
+int32_t AbstractBulletsPool<Derived, Kit, BulletType>::get_active_bullet_index(BulletID id) {
+	if(is_bullet_valid(id)) {
+		return _get_bullet_index(id.index);
+	}
+	return -1;
+}
+
+template <class Derived, class Kit, class BulletType>
+bool AbstractBulletsPool<Derived, Kit, BulletType>::is_bullet_existing(int32_t shape_index) {
+	// Shapes of other pools give -1.
+	int32_t bullet_index = _get_bullet_index(shape_index);
+	return bullet_index >= 0 && bullet_index >= available_bullets;
+}
+
+template <class Derived, class Kit, class BulletType>
+BulletID AbstractBulletsPool<Derived, Kit, BulletType>::get_bullet_from_shape(int32_t shape_index) {
+	int32_t bullet_index = _get_bullet_index(shape_index);
+	if(bullet_index >= 0 && bullet_index >= available_bullets) {
+		return BulletID(shape_index, bullets.cycles[bullet_index], set_index);
 	}
 	return BulletID(-1, -1, -1);
 }
 
 
-template <class Kit, class BulletType>
-void AbstractBulletsPool<Kit, BulletType>::set_bullet_property(BulletID id, String property, Variant value) {
+template <class Derived, class Kit, class BulletType>
+void AbstractBulletsPool<Derived, Kit, BulletType>::_set_property(int32_t index, const String& property, const Variant& value) {
+	int32_t accessor = _get_property_accessor(property);
+	if(accessor >= PROPERTY_BULLET) {
+		bullet_properties[accessor - PROPERTY_BULLET].set(_get_view(index), value);
+		return;
+	}
+	if(accessor >= PROPERTY_CUSTOM) {
+		bullets.custom_columns[accessor - PROPERTY_CUSTOM].set(index, value);
+		return;
+	}
+	BulletType* bullet = _get_view(index);
+
+	// The view setters are called directly when possible, they are the ones of the kit bullet type if it has its own.
+	switch(accessor) {
+		case PROPERTY_TRANSFORM:
+			bullet->set_transform(value);
+			break;
+		case PROPERTY_VELOCITY:
+			bullet->set_velocity(value);
+			break;
+		case PROPERTY_LIFETIME:
+			bullet->set_lifetime(value);
+			break;
+		case PROPERTY_DATA:
+			bullet->set_data(value);
+			break;
+		default:
+			bullet->set(property, value);
+			break;
+	}
+}
+
+template <class Derived, class Kit, class BulletType>
+Variant AbstractBulletsPool<Derived, Kit, BulletType>::_get_property(int32_t index, const String& property) {
+	int32_t accessor = _get_property_accessor(property);
+	if(accessor >= PROPERTY_BULLET) {
+		return bullet_properties[accessor - PROPERTY_BULLET].get(_get_view(index));
+	}
+	if(accessor >= PROPERTY_CUSTOM) {
+		return bullets.custom_columns[accessor - PROPERTY_CUSTOM].get(index);
+	}
+	BulletType* bullet = _get_view(index);
+
+	switch(accessor) {
+		case PROPERTY_TRANSFORM:
+			return bullet->get_transform();
+		case PROPERTY_VELOCITY:
+			return bullet->get_velocity();
+		case PROPERTY_LIFETIME:
+			return bullet->get_lifetime();
+		case PROPERTY_DATA:
+			return bullet->get_data();
+		default:
+			return bullet->get(property);
+	}
+}
+
+template <class Derived, class Kit, class BulletType>
+void AbstractBulletsPool<Derived, Kit, BulletType>::set_bullet_property(BulletID id, String property, Variant value) {
 	if(is_bullet_valid(id)) {
-		int32_t bullet_index = shapes_to_indices[id.index - starting_shape_index];
-		bullets[bullet_index]->set(property, value);
-
-		if(property == "transform") {
-			BulletType* bullet = bullets[bullet_index];
-			VisualServer::get_singleton()->canvas_item_set_transform(bullet->item_rid, bullet->transform);
-			if(collisions_enabled)
-				Physics2DServer::get_singleton()->area_set_shape_transform(shared_area, bullet->shape_index, bullet->transform);
+		int32_t bullet_index = _get_bullet_index(id.index);
+		_set_property(bullet_index, property, value);
+
+		// Whatever the property, the setter marks the transform as dirty if it changed it.
+		if(bullets.transforms_dirty[bullet_index]) {
+			spatial_hash_dirty = true;
+			_upload_transform(bullet_index);
 		}
 	}
 }
 
-template <class Kit, class BulletType>
-Variant AbstractBulletsPool<Kit, BulletType>::get_bullet_property(BulletID id, String property) {
+template <class Derived, class Kit, class BulletType>
+Variant AbstractBulletsPool<Derived, Kit, BulletType>::get_bullet_property(BulletID id, String property) {
 	if(is_bullet_valid(id)) {
-		int32_t bullet_index = shapes_to_indices[id.index - starting_shape_index];
-
-		return bullets[bullet_index]->get(property);
+		return _get_property(_get_bullet_index(id.index), property);
 	}
 	return Variant();
+}
+
+template <class Derived, class Kit, class BulletType>
+bool AbstractBulletsPool<Derived, Kit, BulletType>::set_bullet_transform(BulletID id, Transform2D value) {
+	if(is_bullet_valid(id)) {
+		int32_t bullet_index = _get_bullet_index(id.index);
+		_get_view(bullet_index)->set_transform(value);
+
+		spatial_hash_dirty = true;
+		_upload_transform(bullet_index);
+		return true;
+	}
+	return false;
+}
+
+template <class Derived, class Kit, class BulletType>
+Transform2D AbstractBulletsPool<Derived, Kit, BulletType>::get_bullet_transform(BulletID id) {
+	if(is_bullet_valid(id)) {
+		return _get_view(_get_bullet_index(id.index))->get_transform();
+	}
+	return Transform2D();
+}
+
+template <class Derived, class Kit, class BulletType>
+bool AbstractBulletsPool<Derived, Kit, BulletType>::set_bullet_velocity(BulletID id, Vector2 value) {
+	if(is_bullet_valid(id)) {
+		_get_view(_get_bullet_index(id.index))->set_velocity(value);
+		return true;
+	}
+	return false;
+}
+
+template <class Derived, class Kit, class BulletType>
+Vector2 AbstractBulletsPool<Derived, Kit, BulletType>::get_bullet_velocity(BulletID id) {
+	if(is_bullet_valid(id)) {
+		return _get_view(_get_bullet_index(id.index))->get_velocity();
+	}
+	return Vector2();
+}
+
+template <class Derived, class Kit, class BulletType>
+bool AbstractBulletsPool<Derived, Kit, BulletType>::set_bullet_lifetime(BulletID id, float value) {
+	if(is_bullet_valid(id)) {
+		_get_view(_get_bullet_index(id.index))->set_lifetime(value);
+		return true;
+	}
+	return false;
+}
+
+template <class Derived, class Kit, class BulletType>
+float AbstractBulletsPool<Derived, Kit, BulletType>::get_bullet_lifetime(BulletID id) {
+	if(is_bullet_valid(id)) {
+		return _get_view(_get_bullet_index(id.index))->get_lifetime();
+	}
+	return 0.0f;
 }
\ No newline at end of file
@@ -0,0 +1,68 @@
+#ifndef CURVE_TABLE_H
+#define CURVE_TABLE_H
+
+#include <Godot.hpp>
+#include <Curve.hpp>
+
+#include <vector>
+
+using namespace godot;
+
+
+// A Curve sampled at a fixed resolution, so that it can be evaluated without calling into the engine.
+// Values between samples are linearly interpolated, offsets outside [0, 1] are clamped like Curve does.
+struct CurveTable {
+	static const int32_t resolution = 256;
+
+	std::vector<float> values;
+
+	bool is_valid() const {
+		return !values.empty();
+	}
+
+	void bake(Ref<Curve> curve) {
+		if(curve.is_null()) {
+			values.clear();
+			return;
+		}
+		values.resize(resolution);
+		for(int32_t i = 0; i < resolution; i++) {
+			values[i] = curve->interpolate(i / (float)(resolution - 1));
+		}
+	}
+
+	float sample(float offset) const {
+		int32_t index;
+		float weight;
+		locate(offset, index, weight);
+		return values[index] + (values[index + 1] - values[index]) * weight;
+	}
+
+	// Finds the two samples around `offset` and the weight of the second one,
+	// so that tables derived from the baked values can be sampled the same way.
+	static void locate(float offset, int32_t& index, float& weight) {
+		float position = offset * (resolution - 1);
+		if(position <= 0.0f) {
+			index = 0;
+			weight = 0.0f;
+		} else if(position >= resolution - 1) {
+			index = resolution - 2;
+			weight = 1.0f;
+		} else {
+			index = (int32_t)position;
+			weight = position - index;
+		}
+	}
+
+	// Moves the connection of the "changed" signal from `old_curve` to `new_curve`, so that `owner` can bake it again.
+	static void watch(Object* owner, Ref<Curve> old_curve, Ref<Curve> new_curve, String method) {
+		if(old_curve.is_valid() && old_curve->is_connected("changed", owner, method)) {
+			old_curve->disconnect("changed", owner, method);
+		}
+		if(new_curve.is_valid() && !new_curve->is_connected("changed", owner, method)) {
+			new_curve->connect("changed", owner, method);
+		}
+	}
+};
+
+#endif
\ No newline at end of file
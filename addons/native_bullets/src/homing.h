@@ -0,0 +1,71 @@
+#ifndef HOMING_H
+#define HOMING_H
+
+#include <Godot.hpp>
+#include <cmath>
+
+using namespace godot;
+
+
+// Heading of a homing bullet, kept as a unit direction and a speed so that turning needs no trigonometry.
+struct Heading {
+	Vector2 direction = Vector2(1.0f, 0.0f);
+	float speed = 0.0f;
+
+	Vector2 get_velocity() const {
+		return direction * speed;
+	}
+
+	// Updates the heading if the velocity was changed since it was last written from it, e.g. by scripts.
+	void sync(const Vector2& velocity) {
+		if(velocity == get_velocity()) {
+			return;
+		}
+		speed = velocity.length();
+		if(speed > 0.0f) {
+			direction = velocity / speed;
+		}
+	}
+
+	// Turns the direction towards `to_target`, by the angle at most.
+	// The angle is given as its cosine and sine, so that they can be computed once for many bullets.
+	void turn_towards(const Vector2& to_target, const Vector2& max_turn) {
+		float dot = direction.dot(to_target);
+		float cross = direction.cross(to_target);
+		float length_squared = to_target.length_squared();
+		if(length_squared == 0.0f) {
+			return;
+		}
+		// Compare the cosine of the angle to the target with the one of the max turn, without square roots.
+		float limit = max_turn.x * max_turn.x * length_squared;
+		bool reachable = max_turn.x >= 0.0f ? (dot >= 0.0f && dot * dot >= limit) : (dot >= 0.0f || dot * dot <= limit);
+
+		if(reachable) {
+			direction = to_target / std::sqrt(length_squared);
+			return;
+		}
+		float sine = cross >= 0.0f ? max_turn.y : -max_turn.y;
+		direction = Vector2(direction.x * max_turn.x - direction.y * sine, direction.x * sine + direction.y * max_turn.x);
+		// Cancel the drift of repeated rotations, approximating the normalization to first order.
+		direction *= (3.0f - direction.length_squared()) * 0.5f;
+	}
+
+	static Vector2 turn(float angle) {
+		return Vector2(std::cos(angle), std::sin(angle));
+	}
+
+	// Unsigned angle between the direction and `to_target`, in [0, PI], with an error below 1e-4 radians.
+	// Uses a polynomial approximation of the arc cosine instead of trigonometric functions.
+	float angle_to(const Vector2& to_target) const {
+		float length = to_target.length();
+		if(length == 0.0f) {
+			return 0.0f;
+		}
+		float cosine = direction.dot(to_target) / length;
+		float x = std::abs(cosine) < 1.0f ? std::abs(cosine) : 1.0f;
+		float angle = std::sqrt(1.0f - x) * (1.5707288f + x * (-0.2121144f + x * (0.0742610f - 0.0187293f * x)));
+		return cosine >= 0.0f ? angle : (float)Math_PI - angle;
+	}
+};
+
+#endif
\ No newline at end of file
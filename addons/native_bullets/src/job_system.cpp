@@ -0,0 +1,137 @@
+#include "job_system.h"
+
+
+JobSystem::JobSystem() {
+	queues.push_back(std::unique_ptr<JobsQueue>(new JobsQueue()));
+}
+
+JobSystem::~JobSystem() {
+	_stop_workers();
+}
+
+void JobSystem::set_workers_amount(int32_t amount) {
+	if(amount < 0) {
+		amount = 0;
+	}
+	if(amount == (int32_t)workers.size()) {
+		return;
+	}
+	_stop_workers();
+
+	queues.clear();
+	for(int32_t i = 0; i <= amount; i++) {
+		queues.push_back(std::unique_ptr<JobsQueue>(new JobsQueue()));
+	}
+	quitting = false;
+	for(int32_t i = 0; i < amount; i++) {
+		workers.push_back(std::thread(&JobSystem::_worker_loop, this, i, batch));
+	}
+}
+
+int32_t JobSystem::get_workers_amount() {
+	return (int32_t)workers.size();
+}
+
+void JobSystem::run(int32_t jobs_amount, const std::function<void(int32_t)>& job) {
+	if(workers.empty() || jobs_amount <= 1) {
+		for(int32_t i = 0; i < jobs_amount; i++) {
+			job(i);
+		}
+		return;
+	}
+	// Give each queue a contiguous range of jobs, so that neighbouring jobs tend to run on the same thread.
+	int32_t queues_amount = (int32_t)queues.size();
+	for(int32_t i = 0; i < queues_amount; i++) {
+		int32_t begin = (int32_t)((int64_t)jobs_amount * i / queues_amount);
+		int32_t end = (int32_t)((int64_t)jobs_amount * (i + 1) / queues_amount);
+
+		std::lock_guard<std::mutex> lock(queues[i]->mutex);
+		for(int32_t j = begin; j < end; j++) {
+			queues[i]->jobs.push_back(j);
+		}
+	}
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		this->job = &job;
+		finished_workers = 0;
+		batch += 1;
+	}
+	start_condition.notify_all();
+
+	_run_jobs(queues_amount - 1);
+
+	// Workers may still be running the last jobs they took.
+	std::unique_lock<std::mutex> lock(mutex);
+	done_condition.wait(lock, [this]() { return finished_workers == (int32_t)workers.size(); });
+	this->job = nullptr;
+}
+
+void JobSystem::_worker_loop(int32_t queue_index, uint64_t last_batch) {
+	while(true) {
+		{
+			std::unique_lock<std::mutex> lock(mutex);
+			start_condition.wait(lock, [this, last_batch]() { return quitting || batch != last_batch; });
+			if(quitting) {
+				return;
+			}
+			last_batch = batch;
+		}
+		_run_jobs(queue_index);
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			finished_workers += 1;
+		}
+		done_condition.notify_one();
+	}
+}
+
+void JobSystem::_run_jobs(int32_t queue_index) {
+	int32_t job_index;
+
+	// No jobs are added while a batch runs, so once every queue is empty this thread is done.
+	while(_pop_job(queue_index, job_index) || _steal_job(queue_index, job_index)) {
+		(*job)(job_index);
+	}
+}
+
+bool JobSystem::_pop_job(int32_t queue_index, int32_t& job_index) {
+	JobsQueue* queue = queues[queue_index].get();
+	std::lock_guard<std::mutex> lock(queue->mutex);
+
+	if(queue->jobs.empty()) {
+		return false;
+	}
+	job_index = queue->jobs.front();
+	queue->jobs.pop_front();
+	return true;
+}
+
+bool JobSystem::_steal_job(int32_t queue_index, int32_t& job_index) {
+	int32_t queues_amount = (int32_t)queues.size();
+
+	for(int32_t i = 1; i < queues_amount; i++) {
+		JobsQueue* queue = queues[(queue_index + i) % queues_amount].get();
+		std::lock_guard<std::mutex> lock(queue->mutex);
+
+		// Steal from the opposite end the owner is taking jobs from.
+		if(!queue->jobs.empty()) {
+			job_index = queue->jobs.back();
+			queue->jobs.pop_back();
+			return true;
+		}
+	}
+	return false;
+}
+
+void JobSystem::_stop_workers() {
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		quitting = true;
+	}
+	start_condition.notify_all();
+
+	for(int32_t i = 0; i < (int32_t)workers.size(); i++) {
+		workers[i].join();
+	}
+	workers.clear();
+}
\ No newline at end of file
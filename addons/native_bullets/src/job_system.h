@@ -0,0 +1,54 @@
+#ifndef JOB_SYSTEM_H
+#define JOB_SYSTEM_H
+
+#include <cstdint>
+#include <vector>
+#include <deque>
+#include <memory>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+
+
+// Runs batches of independent jobs on a set of worker threads, with the calling thread helping too.
+// Jobs are split between per-thread queues, threads that run out of jobs steal them from the others.
+class JobSystem {
+
+private:
+	struct JobsQueue {
+		std::mutex mutex;
+		std::deque<int32_t> jobs;
+	};
+
+	std::vector<std::thread> workers;
+	// One queue for each worker, plus the last one for the calling thread.
+	std::vector<std::unique_ptr<JobsQueue>> queues;
+
+	std::mutex mutex;
+	std::condition_variable start_condition;
+	std::condition_variable done_condition;
+	const std::function<void(int32_t)>* job = nullptr;
+	uint64_t batch = 0;
+	int32_t finished_workers = 0;
+	bool quitting = false;
+
+	void _worker_loop(int32_t queue_index, uint64_t last_batch);
+	void _run_jobs(int32_t queue_index);
+	bool _pop_job(int32_t queue_index, int32_t& job_index);
+	bool _steal_job(int32_t queue_index, int32_t& job_index);
+	void _stop_workers();
+
+public:
+	JobSystem();
+	~JobSystem();
+
+	// Number of threads running jobs other than the calling one. Zero disables the workers entirely.
+	void set_workers_amount(int32_t amount);
+	int32_t get_workers_amount();
+
+	// Calls `job` once for each index in [0, jobs_amount) and returns when all of them are completed.
+	void run(int32_t jobs_amount, const std::function<void(int32_t)>& job);
+};
+
+#endif
\ No newline at end of file
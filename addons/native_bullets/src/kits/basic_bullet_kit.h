@@ -26,39 +26,35 @@ public:
 };
 
 // Bullets pool definition.
-class BasicBulletsPool : public AbstractBulletsPool<BasicBulletKit, Bullet> {
+class BasicBulletsPool : public AbstractBulletsPool<BasicBulletsPool, BasicBulletKit, Bullet> {
+public:
 
-	// void _init_bullet(Bullet* bullet); Use default implementation.
+	// void _init_bullet(int32_t index); Use default implementation.
 
-	void _enable_bullet(Bullet* bullet) {
+	void _enable_bullet(int32_t index) {
 		// Reset the bullet lifetime.
-		bullet->lifetime = 0.0f;
-		Rect2 texture_rect = Rect2(-kit->texture->get_size() / 2.0f, kit->texture->get_size());
-		RID texture_rid = kit->texture->get_rid();
-		
-		// Configure the bullet to draw the kit texture each frame.
-		VisualServer::get_singleton()->canvas_item_add_texture_rect(bullet->item_rid,
-			texture_rect,
-			texture_rid);
+		bullets.lifetimes[index] = 0.0f;
 	}
 
-	// void _disable_bullet(Bullet* bullet); Use default implementation.
+	// void _disable_bullet(int32_t index); Use default implementation.
 
-	bool _process_bullet(Bullet* bullet, float delta) {
-		bullet->transform.set_origin(bullet->transform.get_origin() + bullet->velocity * delta);
+	bool _is_thread_safe() {
+		// Processing only reads the pool storage and the kit.
+		return true;
+	}
 
-		if(!active_rect.has_point(bullet->transform.get_origin())) {
-			// Return true if the bullet should be deleted.
-			return true;
-		}
-		// Rotate the bullet based on its velocity "rotate" is enabled.
+	// bool _process_bullet(int32_t index, float delta); Replaced by the batch version below.
+
+	int32_t _process_bullets(float delta, int32_t begin, int32_t end, int32_t* to_release) {
+		// Move all the bullets in range at once, returning the ones outside the active rect.
+		int32_t amount = _integrate_bullets(delta, begin, end, to_release);
+		// Rotate the bullets based on their velocity if "rotate" is enabled.
 		if(kit->rotate) {
-			bullet->transform.set_rotation(bullet->velocity.angle());
+			for(int32_t i = begin; i < end; i++) {
+				bullets.face_velocity(i);
+			}
 		}
-		// Bullet is still alive, increase its lifetime.
-		bullet->lifetime += delta;
-		// Return false if the bullet should not be deleted yet.
-		return false;
+		return amount;
 	}
 };
 
@@ -6,6 +6,7 @@
 #include <Curve.hpp>
 
 #include "../bullet_kit.h"
+#include "../curve_table.h"
 
 using namespace godot;
 
@@ -14,40 +15,73 @@ using namespace godot;
 class DynamicBullet : public Bullet {
 	GODOT_CLASS(DynamicBullet, Bullet)
 public:
-	Transform2D starting_trasform;
-	float starting_speed;
+	struct Fields {
+		Transform2D starting_trasform;
+		float starting_speed = 0.0f;
+	};
+
+	Fields* _fields() {
+		return static_cast<Fields*>(fields);
+	}
 
 	void set_transform(Transform2D transform) {
-		starting_trasform = transform;
-		this->transform = transform;
+		_fields()->starting_trasform = transform;
+		storage->set_transform(index, transform);
 	}
 
 	Transform2D get_transform() {
-		return transform;
+		return storage->get_transform(index);
+	}
+
+	void set_starting_trasform(Transform2D transform) {
+		_fields()->starting_trasform = transform;
+	}
+
+	Transform2D get_starting_trasform() {
+		return _fields()->starting_trasform;
 	}
 
 	void set_velocity(Vector2 velocity) {
-		starting_speed = velocity.length();
-		this->velocity = velocity;
+		_fields()->starting_speed = velocity.length();
+		storage->velocities[index] = velocity;
 	}
 
 	Vector2 get_velocity() {
-		return velocity;
+		return storage->velocities[index];
+	}
+
+	void set_starting_speed(float speed) {
+		_fields()->starting_speed = speed;
+	}
+
+	float get_starting_speed() {
+		return _fields()->starting_speed;
 	}
 
 	void _init() {}
 
+	static std::vector<Property> _get_properties() {
+		std::vector<Property> properties = Bullet::_get_properties();
+		properties.push_back(_property<DynamicBullet, Transform2D,
+			&DynamicBullet::set_starting_trasform, &DynamicBullet::get_starting_trasform>("starting_trasform"));
+		properties.push_back(_property<DynamicBullet, float,
+			&DynamicBullet::set_starting_speed, &DynamicBullet::get_starting_speed>("starting_speed"));
+		return properties;
+	}
+
 	static void _register_methods() {
 		register_property<DynamicBullet, Transform2D>("transform",
 			&DynamicBullet::set_transform,
 			&DynamicBullet::get_transform, Transform2D());
 		register_property<DynamicBullet, Transform2D>("starting_trasform",
-			&DynamicBullet::starting_trasform, Transform2D());
+			&DynamicBullet::set_starting_trasform,
+			&DynamicBullet::get_starting_trasform, Transform2D());
 		register_property<DynamicBullet, Vector2>("velocity",
 			&DynamicBullet::set_velocity,
 			&DynamicBullet::get_velocity, Vector2());
 		register_property<DynamicBullet, float>("starting_speed",
-			&DynamicBullet::starting_speed, 0.0f);
+			&DynamicBullet::set_starting_speed,
+			&DynamicBullet::get_starting_speed, 0.0f);
 	}
 };
 
@@ -62,17 +96,49 @@ public:
 	bool lifetime_curves_loop = true;
 	Ref<Curve> speed_multiplier_over_lifetime;
 	Ref<Curve> rotation_offset_over_lifetime;
+	// Baked copies of the curves, used while processing bullets.
+	CurveTable speed_multiplier_over_lifetime_table;
+	CurveTable rotation_offset_over_lifetime_table;
+
+	void set_speed_multiplier_over_lifetime(Ref<Curve> curve) {
+		CurveTable::watch(this, speed_multiplier_over_lifetime, curve, "_bake_curves");
+		speed_multiplier_over_lifetime = curve;
+		_bake_curves();
+	}
+
+	Ref<Curve> get_speed_multiplier_over_lifetime() {
+		return speed_multiplier_over_lifetime;
+	}
+
+	void set_rotation_offset_over_lifetime(Ref<Curve> curve) {
+		CurveTable::watch(this, rotation_offset_over_lifetime, curve, "_bake_curves");
+		rotation_offset_over_lifetime = curve;
+		_bake_curves();
+	}
+
+	Ref<Curve> get_rotation_offset_over_lifetime() {
+		return rotation_offset_over_lifetime;
+	}
+
+	void _bake_curves() {
+		speed_multiplier_over_lifetime_table.bake(speed_multiplier_over_lifetime);
+		rotation_offset_over_lifetime_table.bake(rotation_offset_over_lifetime);
+	}
 
 	static void _register_methods() {
+		register_method("_bake_curves", &DynamicBulletKit::_bake_curves);
+
 		register_property<DynamicBulletKit, Ref<Texture>>("texture", &DynamicBulletKit::texture, Ref<Texture>(), 
 			GODOT_METHOD_RPC_MODE_DISABLED, GODOT_PROPERTY_USAGE_DEFAULT, GODOT_PROPERTY_HINT_RESOURCE_TYPE, "Texture");
 		register_property<DynamicBulletKit, float>("lifetime_curves_span", &DynamicBulletKit::lifetime_curves_span, 1.0f,
 			GODOT_METHOD_RPC_MODE_DISABLED, GODOT_PROPERTY_USAGE_DEFAULT, GODOT_PROPERTY_HINT_RANGE, "0.001,256.0");
 		register_property<DynamicBulletKit, bool>("lifetime_curves_loop", &DynamicBulletKit::lifetime_curves_loop, true,
 			GODOT_METHOD_RPC_MODE_DISABLED, GODOT_PROPERTY_USAGE_DEFAULT);
-		register_property<DynamicBulletKit, Ref<Curve>>("speed_multiplier_over_lifetime", &DynamicBulletKit::speed_multiplier_over_lifetime, Ref<Curve>(), 
+		register_property<DynamicBulletKit, Ref<Curve>>("speed_multiplier_over_lifetime",
+			&DynamicBulletKit::set_speed_multiplier_over_lifetime, &DynamicBulletKit::get_speed_multiplier_over_lifetime, Ref<Curve>(), 
 			GODOT_METHOD_RPC_MODE_DISABLED, GODOT_PROPERTY_USAGE_DEFAULT, GODOT_PROPERTY_HINT_RESOURCE_TYPE, "Curve");
-		register_property<DynamicBulletKit, Ref<Curve>>("rotation_offset_over_lifetime", &DynamicBulletKit::rotation_offset_over_lifetime, Ref<Curve>(), 
+		register_property<DynamicBulletKit, Ref<Curve>>("rotation_offset_over_lifetime",
+			&DynamicBulletKit::set_rotation_offset_over_lifetime, &DynamicBulletKit::get_rotation_offset_over_lifetime, Ref<Curve>(), 
 			GODOT_METHOD_RPC_MODE_DISABLED, GODOT_PROPERTY_USAGE_DEFAULT, GODOT_PROPERTY_HINT_RESOURCE_TYPE, "Curve");
 		
 		BULLET_KIT_REGISTRATION(DynamicBulletKit, DynamicBullet)
@@ -80,53 +146,54 @@ public:
 };
 
 // Bullets pool definition.
-class DynamicBulletsPool : public AbstractBulletsPool<DynamicBulletKit, DynamicBullet> {
+class DynamicBulletsPool : public AbstractBulletsPool<DynamicBulletsPool, DynamicBulletKit, DynamicBullet> {
+public:
 
-	// void _init_bullet(Bullet* bullet); Use default implementation.
+	// void _init_bullet(int32_t index); Use default implementation.
 
-	void _enable_bullet(DynamicBullet* bullet) {
+	void _enable_bullet(int32_t index) {
 		// Reset the bullet lifetime.
-		bullet->lifetime = 0.0f;
-		Rect2 texture_rect = Rect2(-kit->texture->get_size() / 2.0f, kit->texture->get_size());
-		RID texture_rid = kit->texture->get_rid();
-		
-		// Configure the bullet to draw the kit texture each frame.
-		VisualServer::get_singleton()->canvas_item_add_texture_rect(bullet->item_rid,
-			texture_rect,
-			texture_rid);
+		bullets.lifetimes[index] = 0.0f;
+	}
+
+	// void _disable_bullet(int32_t index); Use default implementation.
+
+	bool _is_thread_safe() {
+		// Processing only reads the pool storage and the kit.
+		return true;
 	}
 
-	// void _disable_bullet(Bullet* bullet); Use default implementation.
+	bool _process_bullet(int32_t index, float delta) {
+		DynamicBullet::Fields& bullet = fields[index];
 
-	bool _process_bullet(DynamicBullet* bullet, float delta) {
-		float adjusted_lifetime = bullet->lifetime / kit->lifetime_curves_span;
+		float adjusted_lifetime = bullets.lifetimes[index] / kit->lifetime_curves_span;
 		if(kit->lifetime_curves_loop) {
 			adjusted_lifetime = fmod(adjusted_lifetime, 1.0f);
 		}
 
-		if(kit->speed_multiplier_over_lifetime.is_valid()) {
-			float speed_multiplier = kit->speed_multiplier_over_lifetime->interpolate(adjusted_lifetime);
-			bullet->velocity = bullet->velocity.normalized() * bullet->starting_speed * speed_multiplier;
+		if(kit->speed_multiplier_over_lifetime_table.is_valid()) {
+			float speed_multiplier = kit->speed_multiplier_over_lifetime_table.sample(adjusted_lifetime);
+			bullets.velocities[index] = bullets.velocities[index].normalized() * bullet.starting_speed * speed_multiplier;
 		}
-		if(kit->rotation_offset_over_lifetime.is_valid()) {
-			float rotation_offset = kit->rotation_offset_over_lifetime->interpolate(adjusted_lifetime);
-			float absolute_rotation = bullet->starting_trasform.get_rotation() + rotation_offset;
+		if(kit->rotation_offset_over_lifetime_table.is_valid()) {
+			float rotation_offset = kit->rotation_offset_over_lifetime_table.sample(adjusted_lifetime);
+			float absolute_rotation = bullet.starting_trasform.get_rotation() + rotation_offset;
 
-			bullet->velocity = bullet->velocity.rotated(absolute_rotation - bullet->transform.get_rotation());
+			bullets.velocities[index] = bullets.velocities[index].rotated(absolute_rotation - bullets.get_rotation(index));
 		}
 
-		bullet->transform.set_origin(bullet->transform.get_origin() + bullet->velocity * delta);
+		bullets.origins[index] += bullets.velocities[index] * delta;
 
-		if(!active_rect.has_point(bullet->transform.get_origin())) {
+		if(!active_rect.has_point(bullets.origins[index])) {
 			// Return true if the bullet should be deleted.
 			return true;
 		}
 		// Rotate the bullet based on its velocity "rotate" is enabled.
 		if(kit->rotate) {
-			bullet->transform.set_rotation(bullet->velocity.angle());
+			bullets.face_velocity(index);
 		}
 		// Bullet is still alive, increase its lifetime.
-		bullet->lifetime += delta;
+		bullets.lifetimes[index] += delta;
 		// Return false if the bullet should not be deleted yet.
 		return false;
 	}
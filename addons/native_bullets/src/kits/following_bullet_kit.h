@@ -8,6 +8,8 @@
 #include <cmath>
 
 #include "../bullet_kit.h"
+#include "../targets_table.h"
+#include "../homing.h"
 
 using namespace godot;
 
@@ -16,16 +18,41 @@ using namespace godot;
 class FollowingBullet : public Bullet {
 	GODOT_CLASS(FollowingBullet, Bullet)
 public:
-	Node2D* target_node = nullptr;
+	struct Fields {
+		// Index of the target in the targets table of the pool, -1 if the bullet has no target.
+		int32_t target = -1;
+		// Used instead of the velocity angle by the "Fast" homing mode.
+		Heading heading;
+	};
+
+	TargetsTable* targets = nullptr;
+
+	Fields* _fields() {
+		return static_cast<Fields*>(fields);
+	}
 
 	void _init() {}
 
 	void set_target_node(Node2D* node) {
-		target_node = node;
+		_fields()->target = targets->add(node);
 	}
 
 	Node2D* get_target_node() {
-		return target_node;
+		return targets->get_node(_fields()->target);
+	}
+
+	static std::vector<Property> _get_properties() {
+		std::vector<Property> properties = Bullet::_get_properties();
+		Property target_node;
+		target_node.name = "target_node";
+		target_node.set = [](Bullet* bullet, const Variant& value) {
+			static_cast<FollowingBullet*>(bullet)->set_target_node(Object::cast_to<Node2D>(value));
+		};
+		target_node.get = [](Bullet* bullet) -> Variant {
+			return static_cast<FollowingBullet*>(bullet)->get_target_node();
+		};
+		properties.push_back(target_node);
+		return properties;
 	}
 
 	static void _register_methods() {
@@ -46,62 +73,118 @@ public:
 
 	Ref<Texture> texture;
 	float bullets_turning_speed = 1.0f;
+	// 0: "Exact", turns velocities by their angle to the target.
+	// 1: "Fast", turns directions with vector products only, the result differs by rounding errors.
+	int32_t homing_mode = 0;
 
 	static void _register_methods() {
 		register_property<FollowingBulletKit, Ref<Texture>>("texture", &FollowingBulletKit::texture, Ref<Texture>(), 
 			GODOT_METHOD_RPC_MODE_DISABLED, GODOT_PROPERTY_USAGE_DEFAULT, GODOT_PROPERTY_HINT_RESOURCE_TYPE, "Texture");
 		register_property<FollowingBulletKit, float>("bullets_turning_speed", &FollowingBulletKit::bullets_turning_speed, 1.0f, 
 			GODOT_METHOD_RPC_MODE_DISABLED, GODOT_PROPERTY_USAGE_DEFAULT, GODOT_PROPERTY_HINT_RANGE, "0.0,128.0");
+		register_property<FollowingBulletKit, int32_t>("homing_mode", &FollowingBulletKit::homing_mode, 0,
+			GODOT_METHOD_RPC_MODE_DISABLED, GODOT_PROPERTY_USAGE_DEFAULT, GODOT_PROPERTY_HINT_ENUM, "Exact,Fast");
 		
 		BULLET_KIT_REGISTRATION(FollowingBulletKit, FollowingBullet)
 	}
 };
 
 // Bullets pool definition.
-class FollowingBulletsPool : public AbstractBulletsPool<FollowingBulletKit, FollowingBullet> {
+class FollowingBulletsPool : public AbstractBulletsPool<FollowingBulletsPool, FollowingBulletKit, FollowingBullet> {
+public:
 
-	//void _init_bullet(FollowingBullet* bullet); Use default implementation.
+	//void _init_bullet(int32_t index); Use default implementation.
 
-	void _enable_bullet(FollowingBullet* bullet) {
+	void _enable_bullet(int32_t index) {
 		// Reset the bullet lifetime.
-		bullet->lifetime = 0.0f;
-		Rect2 texture_rect = Rect2(-kit->texture->get_size() / 2.0f, kit->texture->get_size());
-		RID texture_rid = kit->texture->get_rid();
-		
-		// Configure the bullet to draw the kit texture each frame.
-		VisualServer::get_singleton()->canvas_item_add_texture_rect(bullet->item_rid,
-			texture_rect,
-			texture_rid);
+		bullets.lifetimes[index] = 0.0f;
+		// The heading is synced from the velocity, which may be zero and leave the direction of the previous bullet.
+		fields[index].heading = Heading();
 	}
 
-	//void _disable_bullet(FollowingBullet* bullet); Use default implementation.
+	void _disable_bullet(int32_t index) {
+		// Target indices are only kept valid for active bullets.
+		fields[index].target = -1;
+	}
+
+	bool _is_thread_safe() {
+		// Targets are resolved by _prepare_bullets, processing only reads the pool storage and the kit.
+		return true;
+	}
+
+	// Unique targets of the bullets, with their position for the current frame.
+	TargetsTable targets;
+	// Cosine and sine of the max turn of the current frame, used by the "Fast" homing mode.
+	Vector2 max_turn;
+
+	void _prepare_bullets(float delta) {
+		// Resolve each target once, so processing bullets doesn't go through the scene tree and can run on any thread.
+		targets.begin_update();
+		for(int32_t i = available_bullets; i < pool_size; i++) {
+			fields[i].target = targets.resolve(fields[i].target);
+		}
+		targets.end_update();
+
+		max_turn = Heading::turn(kit->bullets_turning_speed * delta);
+	}
 
-	bool _process_bullet(FollowingBullet* bullet, float delta) {
-		if(bullet->target_node != nullptr) {
+	void _bind_view(FollowingBullet* bullet, int32_t index) {
+		bullet->_bind(&bullets, index, &fields[index]);
+		bullet->targets = &targets;
+	}
+
+	bool _process_bullet(int32_t index, float delta) {
+		if(kit->homing_mode == 1) {
+			return _process_bullet_fast(index, delta);
+		}
+		FollowingBullet::Fields& bullet = fields[index];
+
+		if(bullet.target >= 0) {
 			// Find the rotation to the target node.
-			Vector2 to_target = bullet->target_node->get_global_position() - bullet->transform.get_origin();
-			float rotation_to_target = bullet->velocity.angle_to(to_target);
+			Vector2 to_target = targets.get_position(bullet.target) - bullets.origins[index];
+			float rotation_to_target = bullets.velocities[index].angle_to(to_target);
 			float rotation_value = Math::min(kit->bullets_turning_speed * delta, std::abs(rotation_to_target));
 
 			// Apply the rotation, capped to the max turning speed.
-			bullet->velocity = bullet->velocity.rotated(Math::sign(rotation_to_target) * rotation_value);
+			bullets.velocities[index] = bullets.velocities[index].rotated(Math::sign(rotation_to_target) * rotation_value);
 		}
 		// Apply velocity.
-		bullet->transform.set_origin(bullet->transform.get_origin() + bullet->velocity * delta);
+		bullets.origins[index] += bullets.velocities[index] * delta;
 
-		if(!active_rect.has_point(bullet->transform.get_origin())) {
+		if(!active_rect.has_point(bullets.origins[index])) {
 			// Return true if the bullet should be deleted.
 			return true;
 		}
 		// Rotate the bullet based on its velocity "rotate" is enabled.
 		if(kit->rotate) {
-			bullet->transform.set_rotation(bullet->velocity.angle());
+			bullets.face_velocity(index);
 		}
 		// Bullet is still alive, increase its lifetime.
-		bullet->lifetime += delta;
+		bullets.lifetimes[index] += delta;
 		// Return false if the bullet should not be deleted yet.
 		return false;
 	}
+
+	bool _process_bullet_fast(int32_t index, float delta) {
+		FollowingBullet::Fields& bullet = fields[index];
+		Heading& heading = bullet.heading;
+		heading.sync(bullets.velocities[index]);
+
+		if(bullet.target >= 0) {
+			heading.turn_towards(targets.get_position(bullet.target) - bullets.origins[index], max_turn);
+			bullets.velocities[index] = heading.get_velocity();
+		}
+		bullets.origins[index] += bullets.velocities[index] * delta;
+
+		if(!active_rect.has_point(bullets.origins[index])) {
+			return true;
+		}
+		if(kit->rotate) {
+			bullets.face_velocity(index);
+		}
+		bullets.lifetimes[index] += delta;
+		return false;
+	}
 };
 
 BULLET_KIT_IMPLEMENTATION(FollowingBulletKit, FollowingBulletsPool)
@@ -7,6 +7,9 @@
 #include <Node2D.hpp>
 
 #include "../bullet_kit.h"
+#include "../targets_table.h"
+#include "../homing.h"
+#include "../curve_table.h"
 
 using namespace godot;
 
@@ -15,28 +18,63 @@ using namespace godot;
 class FollowingDynamicBullet : public Bullet {
 	GODOT_CLASS(FollowingDynamicBullet, Bullet)
 public:
-	Node2D* target_node = nullptr;
-	float starting_speed;
+	struct Fields {
+		// Index of the target in the targets table of the pool, -1 if the bullet has no target.
+		int32_t target = -1;
+		float starting_speed = 0.0f;
+		// Used instead of the velocity angle by the "Fast" homing mode.
+		Heading heading;
+	};
+
+	TargetsTable* targets = nullptr;
+
+	Fields* _fields() {
+		return static_cast<Fields*>(fields);
+	}
 
 	void set_target_node(Node2D* node) {
-		target_node = node;
+		_fields()->target = targets->add(node);
 	}
 
 	Node2D* get_target_node() {
-		return target_node;
+		return targets->get_node(_fields()->target);
 	}
 
 	void set_velocity(Vector2 velocity) {
-		starting_speed = velocity.length();
-		this->velocity = velocity;
+		_fields()->starting_speed = velocity.length();
+		storage->velocities[index] = velocity;
 	}
 
 	Vector2 get_velocity() {
-		return velocity;
+		return storage->velocities[index];
+	}
+
+	void set_starting_speed(float speed) {
+		_fields()->starting_speed = speed;
+	}
+
+	float get_starting_speed() {
+		return _fields()->starting_speed;
 	}
 
 	void _init() {}
 
+	static std::vector<Property> _get_properties() {
+		std::vector<Property> properties = Bullet::_get_properties();
+		Property target_node;
+		target_node.name = "target_node";
+		target_node.set = [](Bullet* bullet, const Variant& value) {
+			static_cast<FollowingDynamicBullet*>(bullet)->set_target_node(Object::cast_to<Node2D>(value));
+		};
+		target_node.get = [](Bullet* bullet) -> Variant {
+			return static_cast<FollowingDynamicBullet*>(bullet)->get_target_node();
+		};
+		properties.push_back(target_node);
+		properties.push_back(_property<FollowingDynamicBullet, float,
+			&FollowingDynamicBullet::set_starting_speed, &FollowingDynamicBullet::get_starting_speed>("starting_speed"));
+		return properties;
+	}
+
 	static void _register_methods() {
 		// Registering an Object reference property with GODOT_PROPERTY_HINT_RESOURCE_TYPE and hint_string is just
 		// a way to tell the editor plugin the type of the property, so that it can be viewed in the BulletKit inspector.
@@ -48,7 +86,8 @@ public:
 			&FollowingDynamicBullet::set_velocity,
 			&FollowingDynamicBullet::get_velocity, Vector2());
 		register_property<FollowingDynamicBullet, float>("starting_speed",
-			&FollowingDynamicBullet::starting_speed, 0.0f);
+			&FollowingDynamicBullet::set_starting_speed,
+			&FollowingDynamicBullet::get_starting_speed, 0.0f);
 	}
 };
 
@@ -66,8 +105,41 @@ public:
 	Ref<Curve> speed_multiplier;
 	int32_t turning_speed_control_mode = 0;
 	Ref<Curve> turning_speed;
+	// 0: "Exact", turns velocities by their angle to the target.
+	// 1: "Fast", turns directions with vector products only, the result differs by rounding errors.
+	int32_t homing_mode = 0;
+	// Baked copies of the curves, used while processing bullets.
+	CurveTable speed_multiplier_table;
+	CurveTable turning_speed_table;
+
+	void set_speed_multiplier(Ref<Curve> curve) {
+		CurveTable::watch(this, speed_multiplier, curve, "_bake_curves");
+		speed_multiplier = curve;
+		_bake_curves();
+	}
+
+	Ref<Curve> get_speed_multiplier() {
+		return speed_multiplier;
+	}
+
+	void set_turning_speed(Ref<Curve> curve) {
+		CurveTable::watch(this, turning_speed, curve, "_bake_curves");
+		turning_speed = curve;
+		_bake_curves();
+	}
+
+	Ref<Curve> get_turning_speed() {
+		return turning_speed;
+	}
+
+	void _bake_curves() {
+		speed_multiplier_table.bake(speed_multiplier);
+		turning_speed_table.bake(turning_speed);
+	}
 
 	static void _register_methods() {
+		register_method("_bake_curves", &FollowingDynamicBulletKit::_bake_curves);
+
 		register_property<FollowingDynamicBulletKit, Ref<Texture>>("texture", &FollowingDynamicBulletKit::texture, Ref<Texture>(), 
 			GODOT_METHOD_RPC_MODE_DISABLED, GODOT_PROPERTY_USAGE_DEFAULT, GODOT_PROPERTY_HINT_RESOURCE_TYPE, "Texture");
 		register_property<FollowingDynamicBulletKit, float>("lifetime_curves_span", &FollowingDynamicBulletKit::lifetime_curves_span, 1.0f,
@@ -80,112 +152,213 @@ public:
 			GODOT_METHOD_RPC_MODE_DISABLED, GODOT_PROPERTY_USAGE_DEFAULT, GODOT_PROPERTY_HINT_ENUM,
 			"Based On Lifetime,Based On Target Distance,Based On Angle To Target");
 		register_property<FollowingDynamicBulletKit, Ref<Curve>>("speed_multiplier",
-			&FollowingDynamicBulletKit::speed_multiplier, Ref<Curve>(), 
+			&FollowingDynamicBulletKit::set_speed_multiplier, &FollowingDynamicBulletKit::get_speed_multiplier, Ref<Curve>(), 
 			GODOT_METHOD_RPC_MODE_DISABLED, GODOT_PROPERTY_USAGE_DEFAULT, GODOT_PROPERTY_HINT_RESOURCE_TYPE, "Curve");
 		register_property<FollowingDynamicBulletKit, int32_t>("turning_speed_control_mode",
 			&FollowingDynamicBulletKit::turning_speed_control_mode, 0,
 			GODOT_METHOD_RPC_MODE_DISABLED, GODOT_PROPERTY_USAGE_DEFAULT, GODOT_PROPERTY_HINT_ENUM,
 			"Based On Lifetime,Based On Target Distance,Based On Angle To Target");
 		register_property<FollowingDynamicBulletKit, Ref<Curve>>("turning_speed",
-			&FollowingDynamicBulletKit::turning_speed, Ref<Curve>(), 
+			&FollowingDynamicBulletKit::set_turning_speed, &FollowingDynamicBulletKit::get_turning_speed, Ref<Curve>(), 
 			GODOT_METHOD_RPC_MODE_DISABLED, GODOT_PROPERTY_USAGE_DEFAULT, GODOT_PROPERTY_HINT_RESOURCE_TYPE, "Curve");
+		register_property<FollowingDynamicBulletKit, int32_t>("homing_mode", &FollowingDynamicBulletKit::homing_mode, 0,
+			GODOT_METHOD_RPC_MODE_DISABLED, GODOT_PROPERTY_USAGE_DEFAULT, GODOT_PROPERTY_HINT_ENUM, "Exact,Fast");
 		
 		BULLET_KIT_REGISTRATION(FollowingDynamicBulletKit, FollowingDynamicBullet)
 	}
 };
 
 // Bullets pool definition.
-class FollowingDynamicBulletsPool : public AbstractBulletsPool<FollowingDynamicBulletKit, FollowingDynamicBullet> {
+class FollowingDynamicBulletsPool : public AbstractBulletsPool<FollowingDynamicBulletsPool, FollowingDynamicBulletKit, FollowingDynamicBullet> {
+public:
 
-	// void _init_bullet(FollowingDynamicBullet* bullet); Use default implementation.
+	// void _init_bullet(int32_t index); Use default implementation.
 
-	void _enable_bullet(FollowingDynamicBullet* bullet) {
+	void _enable_bullet(int32_t index) {
 		// Reset the bullet lifetime.
-		bullet->lifetime = 0.0f;
-		Rect2 texture_rect = Rect2(-kit->texture->get_size() / 2.0f, kit->texture->get_size());
-		RID texture_rid = kit->texture->get_rid();
-		
-		// Configure the bullet to draw the kit texture each frame.
-		VisualServer::get_singleton()->canvas_item_add_texture_rect(bullet->item_rid,
-			texture_rect,
-			texture_rid);
+		bullets.lifetimes[index] = 0.0f;
+		// The heading is synced from the velocity, which may be zero and leave the direction of the previous bullet.
+		fields[index].heading = Heading();
 	}
 
-	// void _disable_bullet(FollowingDynamicBullet* bullet); Use default implementation.
+	void _disable_bullet(int32_t index) {
+		// Target indices are only kept valid for active bullets.
+		fields[index].target = -1;
+	}
 
-	bool _process_bullet(FollowingDynamicBullet* bullet, float delta) {
-		float adjusted_lifetime = bullet->lifetime / kit->lifetime_curves_span;
+	bool _is_thread_safe() {
+		// Targets are resolved by _prepare_bullets, processing only reads the pool storage and the kit.
+		return true;
+	}
+
+	// Unique targets of the bullets, with their position for the current frame.
+	TargetsTable targets;
+	// Cosine and sine of the max turn of the current frame for each value of the turning speed table,
+	// used by the "Fast" homing mode.
+	std::vector<Vector2> max_turns;
+
+	void _prepare_bullets(float delta) {
+		// Resolve each target once, so processing bullets doesn't go through the scene tree and can run on any thread.
+		targets.begin_update();
+		for(int32_t i = available_bullets; i < pool_size; i++) {
+			fields[i].target = targets.resolve(fields[i].target);
+		}
+		targets.end_update();
+
+		if(kit->homing_mode == 1 && kit->turning_speed_table.is_valid()) {
+			const std::vector<float>& values = kit->turning_speed_table.values;
+			max_turns.resize(values.size());
+			for(int32_t i = 0; i < (int32_t)values.size(); i++) {
+				max_turns[i] = Heading::turn(values[i] * delta);
+			}
+		}
+	}
+
+	void _bind_view(FollowingDynamicBullet* bullet, int32_t index) {
+		bullet->_bind(&bullets, index, &fields[index]);
+		bullet->targets = &targets;
+	}
+
+	bool _process_bullet(int32_t index, float delta) {
+		if(kit->homing_mode == 1) {
+			return _process_bullet_fast(index, delta);
+		}
+		FollowingDynamicBullet::Fields& bullet = fields[index];
+
+		float adjusted_lifetime = bullets.lifetimes[index] / kit->lifetime_curves_span;
 		if(kit->lifetime_curves_loop) {
 			adjusted_lifetime = fmod(adjusted_lifetime, 1.0f);
 		}
 		float bullet_turning_speed = 0.0f;
 		float speed_multiplier = 1.0f;
+		bool has_target = bullet.target >= 0;
+		Vector2 to_target = has_target ? targets.get_position(bullet.target) - bullets.origins[index] : Vector2();
 		
-		if(kit->turning_speed.is_valid() && bullet->target_node != nullptr) {
-			Vector2 to_target = bullet->target_node->get_global_position() - bullet->transform.get_origin();
+		if(kit->turning_speed_table.is_valid() && has_target) {
 			// If based on lifetime.
 			if(kit->turning_speed_control_mode == 0) {
-				bullet_turning_speed = kit->turning_speed->interpolate(adjusted_lifetime);
+				bullet_turning_speed = kit->turning_speed_table.sample(adjusted_lifetime);
 			}
 			// If based on distance to target.
 			else if(kit->turning_speed_control_mode == 1) {
 				float distance_to_target = to_target.length();
-				bullet_turning_speed = kit->turning_speed->interpolate(distance_to_target / kit->distance_curves_span);
+				bullet_turning_speed = kit->turning_speed_table.sample(distance_to_target / kit->distance_curves_span);
 			}
 			// If based on angle to target.
 			else if(kit->turning_speed_control_mode == 2) {
-				float angle_to_target = bullet->velocity.angle_to(to_target);
-				bullet_turning_speed = kit->turning_speed->interpolate(std::abs(angle_to_target) / (float)Math_PI);
+				float angle_to_target = bullets.velocities[index].angle_to(to_target);
+				bullet_turning_speed = kit->turning_speed_table.sample(std::abs(angle_to_target) / (float)Math_PI);
 			}
 		}
-		if(kit->speed_multiplier.is_valid()) {
+		if(kit->speed_multiplier_table.is_valid()) {
 			// If based on lifetime.
 			if(kit->speed_control_mode <= 0) {
-				speed_multiplier = kit->speed_multiplier->interpolate(adjusted_lifetime);
+				speed_multiplier = kit->speed_multiplier_table.sample(adjusted_lifetime);
 			}
 			// If based on target node: 1 or 2.
-			else if(kit->speed_control_mode < 3 && bullet->target_node != nullptr) {
-				Vector2 to_target = bullet->target_node->get_global_position() - bullet->transform.get_origin();
+			else if(kit->speed_control_mode < 3 && has_target) {
 				// If based on distance to target.
 				if(kit->speed_control_mode == 1) {
 					float distance_to_target = to_target.length();
-					speed_multiplier = kit->speed_multiplier->interpolate(distance_to_target / kit->distance_curves_span);
+					speed_multiplier = kit->speed_multiplier_table.sample(distance_to_target / kit->distance_curves_span);
 				}
 				// If based on angle to target.
 				else if(kit->speed_control_mode == 2) {
-					float angle_to_target = bullet->velocity.angle_to(to_target);
-					speed_multiplier = kit->speed_multiplier->interpolate(std::abs(angle_to_target) / (float)Math_PI);
+					float angle_to_target = bullets.velocities[index].angle_to(to_target);
+					speed_multiplier = kit->speed_multiplier_table.sample(std::abs(angle_to_target) / (float)Math_PI);
 				}
 			}
 		}
 
 		if(speed_multiplier != 1.0f) {
-			bullet->velocity = bullet->velocity.normalized() * bullet->starting_speed * speed_multiplier;
+			bullets.velocities[index] = bullets.velocities[index].normalized() * bullet.starting_speed * speed_multiplier;
 		}
-		if(bullet_turning_speed != 0.0 && bullet->target_node != nullptr) {
+		if(bullet_turning_speed != 0.0 && has_target) {
 			// Find the rotation to the target node.
-			Vector2 to_target = bullet->target_node->get_global_position() - bullet->transform.get_origin();
-			float rotation_to_target = bullet->velocity.angle_to(to_target);
+			float rotation_to_target = bullets.velocities[index].angle_to(to_target);
 			float rotation_value = Math::min(bullet_turning_speed * delta, std::abs(rotation_to_target));
 			// Apply the rotation, capped to the max turning speed.
-			bullet->velocity = bullet->velocity.rotated(Math::sign(rotation_to_target) * rotation_value);
+			bullets.velocities[index] = bullets.velocities[index].rotated(Math::sign(rotation_to_target) * rotation_value);
 		}
 
-		bullet->transform.set_origin(bullet->transform.get_origin() + bullet->velocity * delta);
+		bullets.origins[index] += bullets.velocities[index] * delta;
 
-		if(!active_rect.has_point(bullet->transform.get_origin())) {
+		if(!active_rect.has_point(bullets.origins[index])) {
 			// Return true if the bullet should be deleted.
 			return true;
 		}
 		// Rotate the bullet based on its velocity "rotate" is enabled.
 		if(kit->rotate) {
-			bullet->transform.set_rotation(bullet->velocity.angle());
+			bullets.face_velocity(index);
 		}
 		// Bullet is still alive, increase its lifetime.
-		bullet->lifetime += delta;
+		bullets.lifetimes[index] += delta;
 		// Return false if the bullet should not be deleted yet.
 		return false;
 	}
+
+	// Offset used to sample a curve, given its control mode. Returns false if the mode needs a missing target.
+	bool _get_curve_offset(int32_t mode, float adjusted_lifetime, const Heading& heading, bool has_target,
+			const Vector2& to_target, float& offset) {
+		if(mode <= 0) {
+			offset = adjusted_lifetime;
+			return true;
+		}
+		if(!has_target || mode > 2) {
+			return false;
+		}
+		if(mode == 1) {
+			offset = to_target.length() / kit->distance_curves_span;
+		} else {
+			offset = heading.angle_to(to_target) / (float)Math_PI;
+		}
+		return true;
+	}
+
+	bool _process_bullet_fast(int32_t index, float delta) {
+		FollowingDynamicBullet::Fields& bullet = fields[index];
+		Heading& heading = bullet.heading;
+		heading.sync(bullets.velocities[index]);
+
+		float adjusted_lifetime = bullets.lifetimes[index] / kit->lifetime_curves_span;
+		if(kit->lifetime_curves_loop) {
+			adjusted_lifetime = fmod(adjusted_lifetime, 1.0f);
+		}
+		bool has_target = bullet.target >= 0;
+		Vector2 to_target = has_target ? targets.get_position(bullet.target) - bullets.origins[index] : Vector2();
+		float offset;
+
+		if(kit->speed_multiplier_table.is_valid() &&
+				_get_curve_offset(kit->speed_control_mode, adjusted_lifetime, heading, has_target, to_target, offset)) {
+			float speed_multiplier = kit->speed_multiplier_table.sample(offset);
+			if(speed_multiplier != 1.0f) {
+				heading.speed = bullet.starting_speed * speed_multiplier;
+			}
+		}
+		if(kit->turning_speed_table.is_valid() && has_target &&
+				_get_curve_offset(kit->turning_speed_control_mode, adjusted_lifetime, heading, has_target, to_target, offset)) {
+			int32_t turn_index;
+			float weight;
+			CurveTable::locate(offset, turn_index, weight);
+			// Interpolated rotations are slightly shorter than unit vectors, their cosine is only exact once normalized.
+			Vector2 max_turn = max_turns[turn_index] + (max_turns[turn_index + 1] - max_turns[turn_index]) * weight;
+			float length_squared = max_turn.length_squared();
+			if(length_squared > 0.0f) {
+				heading.turn_towards(to_target, max_turn / std::sqrt(length_squared));
+			}
+		}
+		bullets.velocities[index] = heading.get_velocity();
+		bullets.origins[index] += bullets.velocities[index] * delta;
+
+		if(!active_rect.has_point(bullets.origins[index])) {
+			return true;
+		}
+		if(kit->rotate) {
+			bullets.face_velocity(index);
+		}
+		bullets.lifetimes[index] += delta;
+		return false;
+	}
 };
 
 BULLET_KIT_IMPLEMENTATION(FollowingDynamicBulletKit, FollowingDynamicBulletsPool)
@@ -0,0 +1,142 @@
+#include <CircleShape2D.hpp>
+#include <RectangleShape2D.hpp>
+
+#include "native_collisions.h"
+
+using namespace godot;
+
+
+NativeShape NativeShape::from_shape(Ref<Shape2D> shape) {
+	NativeShape native_shape;
+
+	if(CircleShape2D* circle = Object::cast_to<CircleShape2D>(shape.ptr())) {
+		native_shape.type = CIRCLE;
+		native_shape.radius = circle->get_radius();
+	} else if(RectangleShape2D* rectangle = Object::cast_to<RectangleShape2D>(shape.ptr())) {
+		native_shape.type = RECTANGLE;
+		native_shape.extents = rectangle->get_extents();
+	}
+	return native_shape;
+}
+
+Vector2 NativeShape::get_half_size() const {
+	if(type == CIRCLE) {
+		return Vector2(radius, radius);
+	}
+	return extents;
+}
+
+bool NativeShape::overlaps(Vector2 position, const NativeShape& other, Vector2 other_position) const {
+	if(type == NONE || other.type == NONE) {
+		return false;
+	}
+	Vector2 offset = other_position - position;
+
+	if(type == CIRCLE && other.type == CIRCLE) {
+		float distance = radius + other.radius;
+		return offset.x * offset.x + offset.y * offset.y <= distance * distance;
+	}
+	if(type == RECTANGLE && other.type == RECTANGLE) {
+		return std::abs(offset.x) <= extents.x + other.extents.x && std::abs(offset.y) <= extents.y + other.extents.y;
+	}
+	// Circle against box: distance from the circle center to the closest point of the box.
+	const NativeShape& circle = type == CIRCLE ? *this : other;
+	const NativeShape& box = type == CIRCLE ? other : *this;
+	float distance_x = std::abs(offset.x) - box.extents.x;
+	float distance_y = std::abs(offset.y) - box.extents.y;
+	distance_x = distance_x > 0.0f ? distance_x : 0.0f;
+	distance_y = distance_y > 0.0f ? distance_y : 0.0f;
+
+	return distance_x * distance_x + distance_y * distance_y <= circle.radius * circle.radius;
+}
+
+QueryRegion QueryRegion::from_rect(Rect2 rect) {
+	QueryRegion region;
+	region.type = RECT;
+	region.rect = rect;
+	return region;
+}
+
+QueryRegion QueryRegion::from_circle(Vector2 center, float radius) {
+	QueryRegion region;
+	region.type = CIRCLE;
+	region.from = center;
+	region.to = center;
+	region.radius = radius;
+	return region;
+}
+
+QueryRegion QueryRegion::from_capsule(Vector2 from, Vector2 to, float radius) {
+	QueryRegion region;
+	region.type = CAPSULE;
+	region.from = from;
+	region.to = to;
+	region.radius = radius;
+	return region;
+}
+
+Rect2 QueryRegion::get_bounds() const {
+	if(type == RECT) {
+		return rect;
+	}
+	Vector2 start = Vector2(from.x < to.x ? from.x : to.x, from.y < to.y ? from.y : to.y);
+	Vector2 end = Vector2(from.x > to.x ? from.x : to.x, from.y > to.y ? from.y : to.y);
+	return Rect2(start - Vector2(radius, radius), end - start + Vector2(radius, radius) * 2.0f);
+}
+
+bool QueryRegion::has_point(Vector2 point) const {
+	if(type == RECT) {
+		return point.x >= rect.position.x && point.y >= rect.position.y &&
+			point.x <= rect.position.x + rect.size.x && point.y <= rect.position.y + rect.size.y;
+	}
+	Vector2 closest = from;
+	if(type == CAPSULE) {
+		// Closest point to `point` on the capsule segment.
+		Vector2 segment = to - from;
+		float length_squared = segment.x * segment.x + segment.y * segment.y;
+		if(length_squared > 0.0f) {
+			Vector2 offset = point - from;
+			float t = (offset.x * segment.x + offset.y * segment.y) / length_squared;
+			t = t < 0.0f ? 0.0f : (t > 1.0f ? 1.0f : t);
+			closest = from + segment * t;
+		}
+	}
+	Vector2 offset = point - closest;
+	return offset.x * offset.x + offset.y * offset.y <= radius * radius;
+}
+
+void SpatialHash::clear(float cell_size) {
+	this->cell_size = cell_size > 0.0f ? cell_size : 1.0f;
+	inserted_entries.clear();
+}
+
+void SpatialHash::insert(Vector2 position, int32_t item) {
+	Entry entry;
+	entry.cell_x = _get_cell(position.x);
+	entry.cell_y = _get_cell(position.y);
+	entry.item = item;
+	inserted_entries.push_back(entry);
+}
+
+void SpatialHash::build() {
+	int32_t amount = (int32_t)inserted_entries.size();
+	int32_t buckets_amount = 1;
+	while(buckets_amount < amount * 2) {
+		buckets_amount <<= 1;
+	}
+	buckets_mask = buckets_amount - 1;
+
+	// Counting sort of the entries by bucket.
+	buckets_starts.assign(buckets_amount + 1, 0);
+	for(const Entry& entry : inserted_entries) {
+		buckets_starts[_get_bucket(entry.cell_x, entry.cell_y) + 1] += 1;
+	}
+	for(int32_t i = 0; i < buckets_amount; i++) {
+		buckets_starts[i + 1] += buckets_starts[i];
+	}
+	buckets_cursors.assign(buckets_starts.begin(), buckets_starts.end() - 1);
+	entries.resize(amount);
+	for(const Entry& entry : inserted_entries) {
+		entries[buckets_cursors[_get_bucket(entry.cell_x, entry.cell_y)]++] = entry;
+	}
+}
\ No newline at end of file
@@ -0,0 +1,146 @@
+#ifndef NATIVE_COLLISIONS_H
+#define NATIVE_COLLISIONS_H
+
+#include <Godot.hpp>
+#include <Node2D.hpp>
+#include <Shape2D.hpp>
+#include <Vector2.hpp>
+#include <Rect2.hpp>
+
+#include <vector>
+#include <cmath>
+
+using namespace godot;
+
+
+// Shapes supported by native collisions.
+// Rectangles are treated as axis aligned boxes, the rotation and scale of bullets and targets are ignored.
+struct NativeShape {
+	enum Type {
+		NONE,
+		CIRCLE,
+		RECTANGLE
+	};
+
+	Type type = NONE;
+	float radius = 0.0f;
+	Vector2 extents;
+
+	// Returns a shape of type NONE if `shape` is neither a CircleShape2D nor a RectangleShape2D.
+	static NativeShape from_shape(Ref<Shape2D> shape);
+
+	// Half the size of the box containing the shape.
+	Vector2 get_half_size() const;
+	bool overlaps(Vector2 position, const NativeShape& other, Vector2 other_position) const;
+};
+
+// Region used to look for bullets by position.
+struct QueryRegion {
+	enum Type {
+		RECT,
+		CIRCLE,
+		CAPSULE
+	};
+
+	Type type = RECT;
+	Rect2 rect;
+	// Circles use only `from`, capsules are the points within `radius` from the segment between `from` and `to`.
+	Vector2 from;
+	Vector2 to;
+	float radius = 0.0f;
+
+	static QueryRegion from_rect(Rect2 rect);
+	static QueryRegion from_circle(Vector2 center, float radius);
+	static QueryRegion from_capsule(Vector2 from, Vector2 to, float radius);
+
+	Rect2 get_bounds() const;
+	bool has_point(Vector2 point) const;
+};
+
+// A node tested against the bullets using native collisions.
+struct CollisionTarget {
+	int64_t instance_id;
+	// Refreshed each frame from the instance ID, along with the position.
+	Node2D* node;
+	Vector2 position;
+	NativeShape shape;
+	int32_t collision_mask;
+};
+
+// Uniform grid over a set of points, stored as a hash table that is rebuilt from scratch each frame.
+class SpatialHash {
+
+private:
+	struct Entry {
+		int32_t cell_x;
+		int32_t cell_y;
+		int32_t item;
+	};
+
+	float cell_size = 64.0f;
+	std::vector<Entry> inserted_entries;
+	// Entries sorted by bucket, each bucket spans [buckets_starts[b], buckets_starts[b + 1]).
+	std::vector<Entry> entries;
+	std::vector<int32_t> buckets_starts;
+	std::vector<int32_t> buckets_cursors;
+	int32_t buckets_mask = 0;
+
+	// Cells are clamped to a range that fits in int32 even after the query arithmetic, so that huge or infinite
+	// coordinates don't overflow. Negated comparisons also send NaN to the lower bound.
+	inline int32_t _get_cell(float coordinate) const {
+		const float limit = (float)(1 << 30);
+		float cell = std::floor(coordinate / cell_size);
+		if(!(cell > -limit)) {
+			return -(1 << 30);
+		}
+		if(!(cell < limit)) {
+			return 1 << 30;
+		}
+		return (int32_t)cell;
+	}
+
+	inline int32_t _get_bucket(int32_t cell_x, int32_t cell_y) const {
+		return (int32_t)(((uint32_t)cell_x * 73856093u) ^ ((uint32_t)cell_y * 19349663u)) & buckets_mask;
+	}
+
+public:
+	void clear(float cell_size);
+	void insert(Vector2 position, int32_t item);
+	void build();
+
+	// Calls `callback` with each item inside the cells overlapping `rect`, which may lie outside of it.
+	template <class Callback>
+	void query(Rect2 rect, Callback callback) const {
+		if(entries.empty()) {
+			return;
+		}
+		int32_t start_x = _get_cell(rect.position.x);
+		int32_t start_y = _get_cell(rect.position.y);
+		int32_t end_x = _get_cell(rect.position.x + rect.size.x);
+		int32_t end_y = _get_cell(rect.position.y + rect.size.y);
+
+		// Walking all the entries is cheaper than visiting more cells than there are entries.
+		if(((int64_t)end_x - start_x + 1) * ((int64_t)end_y - start_y + 1) > (int64_t)entries.size()) {
+			for(const Entry& entry : entries) {
+				if(entry.cell_x >= start_x && entry.cell_x <= end_x && entry.cell_y >= start_y && entry.cell_y <= end_y) {
+					callback(entry.item);
+				}
+			}
+			return;
+		}
+		for(int32_t y = start_y; y <= end_y; y++) {
+			for(int32_t x = start_x; x <= end_x; x++) {
+				int32_t bucket = _get_bucket(x, y);
+
+				for(int32_t i = buckets_starts[bucket]; i < buckets_starts[bucket + 1]; i++) {
+					// Different cells can share the same bucket.
+					if(entries[i].cell_x == x && entries[i].cell_y == y) {
+						callback(entries[i].item);
+					}
+				}
+			}
+		}
+	}
+};
+
+#endif
\ No newline at end of file
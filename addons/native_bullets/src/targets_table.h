@@ -0,0 +1,108 @@
+#ifndef TARGETS_TABLE_H
+#define TARGETS_TABLE_H
+
+#include <Godot.hpp>
+#include <Node2D.hpp>
+
+#include <vector>
+
+using namespace godot;
+
+
+// Nodes followed by the bullets of a pool, referenced by bullets through their index in the table.
+// Targets are stored by instance ID and resolved once per frame, so freed nodes are detected
+// instead of being accessed, and bullets sharing a target don't query its position again.
+struct TargetsTable {
+	struct Target {
+		int64_t instance_id = 0;
+		Node2D* node = nullptr;
+		Vector2 position;
+		bool valid = false;
+	};
+
+	std::vector<Target> targets;
+	std::vector<bool> used;
+
+	// Returns the index of the target, adding it if needed. A null node gives -1.
+	int32_t add(Node2D* node) {
+		if(node == nullptr) {
+			return -1;
+		}
+		int64_t instance_id = node->get_instance_id();
+		int32_t free_index = -1;
+		for(int32_t i = 0; i < (int32_t)targets.size(); i++) {
+			if(targets[i].instance_id == instance_id) {
+				return i;
+			}
+			if(free_index < 0 && targets[i].instance_id == 0) {
+				free_index = i;
+			}
+		}
+		if(free_index < 0) {
+			free_index = (int32_t)targets.size();
+			targets.emplace_back();
+		}
+		Target& target = targets[free_index];
+		target.instance_id = instance_id;
+		target.node = node;
+		target.position = node->get_global_position();
+		target.valid = true;
+		return free_index;
+	}
+
+	// Returns the node of the target, or null if it has been freed.
+	Node2D* get_node(int32_t index) const {
+		if(index < 0 || index >= (int32_t)targets.size() || targets[index].instance_id == 0) {
+			return nullptr;
+		}
+		godot_object* object = core_1_1_api->godot_instance_from_id(targets[index].instance_id);
+		if(object == nullptr) {
+			return nullptr;
+		}
+		return godot::detail::get_wrapper<Node2D>(object);
+	}
+
+	bool is_valid(int32_t index) const {
+		return index >= 0 && targets[index].valid;
+	}
+
+	const Vector2& get_position(int32_t index) const {
+		return targets[index].position;
+	}
+
+	// Updating the table is done by calling `resolve` on the target index of each active bullet,
+	// between `begin_update` and `end_update`. Targets that are no longer referenced are removed.
+	void begin_update() {
+		used.assign(targets.size(), false);
+	}
+
+	// Caches the position of the target for this frame. Returns the index to keep, -1 if the target has been freed.
+	int32_t resolve(int32_t index) {
+		if(index < 0) {
+			return -1;
+		}
+		Target& target = targets[index];
+		if(!used[index]) {
+			used[index] = true;
+			godot_object* object = core_1_1_api->godot_instance_from_id(target.instance_id);
+			if(object == nullptr) {
+				target.node = nullptr;
+				target.valid = false;
+			} else {
+				target.node = godot::detail::get_wrapper<Node2D>(object);
+				target.position = target.node->get_global_position();
+			}
+		}
+		return target.valid ? index : -1;
+	}
+
+	void end_update() {
+		for(int32_t i = 0; i < (int32_t)targets.size(); i++) {
+			if(!used[i] || !targets[i].valid) {
+				targets[i] = Target();
+			}
+		}
+	}
+};
+
+#endif
\ No newline at end of file
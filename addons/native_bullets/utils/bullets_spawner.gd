@@ -19,15 +19,18 @@ func shoot(recover_seconds = 0.0):
 	if not enabled:
 		return
 	
+	var positions = PoolVector2Array()
+	var velocities = PoolVector2Array()
+	var rotations = PoolRealArray()
+	
 	for spawner in get_children():
 		var bullet_rotation = spawner.global_rotation
 		var bullet_velocity = Vector2(cos(bullet_rotation), sin(bullet_rotation)) * bullets_speed
 		
-		var properties = {
-			"transform": Transform2D(bullet_rotation, spawner.global_position \
-				+ bullet_velocity * recover_seconds \
-				+ bullet_velocity.normalized() * bullets_spawn_distance),
-			"velocity": bullet_velocity
-		}
-		# Use this assigned BulletKit to spawn a bullet.
-		Bullets.spawn_bullet(bullet_kit, properties)
+		positions.append(spawner.global_position \
+			+ bullet_velocity * recover_seconds \
+			+ bullet_velocity.normalized() * bullets_spawn_distance)
+		velocities.append(bullet_velocity)
+		rotations.append(bullet_rotation)
+	# Use this assigned BulletKit to spawn all the bullets at once.
+	Bullets.spawn_bullets(bullet_kit, positions, velocities, rotations, PoolRealArray())